@@ -44,6 +44,198 @@ namespace AK
 {
 	namespace DSP
 	{
+#ifdef AKSIMD_V8F32_SUPPORTED
+		/// Single channel, in-place interpolating gain, AKSIMD_V8F32 implementation (do not call directly) use ApplyGain instead.
+		static inline AKSIMD_V8F32_FUNC void ApplyGainRampV8F32(	
+			AkSampleType * AK_RESTRICT io_pfBuffer, 
+			AkReal32 in_fCurGain,
+			AkReal32 in_fTargetGain,
+			AkUInt32 in_uNumFrames )
+		{
+			AkSampleType * AK_RESTRICT pfBuf = (AkSampleType *) io_pfBuffer;
+			const AkSampleType * const pfEnd = io_pfBuffer + in_uNumFrames;
+
+			const AkUInt32 uNumVecIter = in_uNumFrames/8;
+			if(uNumVecIter)
+			{
+				CAkVectorValueRampV8 vGainRamp;
+				AKSIMD_V8F32 vfGain = vGainRamp.Setup(in_fCurGain,in_fTargetGain,in_uNumFrames);	
+				const AkSampleType * const pfVecEnd = io_pfBuffer + uNumVecIter*8;
+				while ( pfBuf < pfVecEnd )
+				{
+					AKSIMD_V8F32 vfIn = AKSIMD_LOADU_V8F32(pfBuf);
+					AKSIMD_V8F32 vfOut = AKSIMD_MUL_V8F32( vfIn, vfGain );
+					AKSIMD_STOREU_V8F32( pfBuf, vfOut );
+					vfGain = vGainRamp.Tick();
+					pfBuf+=8;
+				}
+			}
+
+			if ( pfBuf < pfEnd )
+			{
+				// Continue the ramp from the gain reached by the vector loop.
+				const AkReal32 fInc = (in_fTargetGain - in_fCurGain) / in_uNumFrames;
+				in_fCurGain += fInc * (AkReal32)( uNumVecIter*8 );
+				do
+				{
+					*pfBuf = (AkSampleType)(*pfBuf * in_fCurGain);
+					in_fCurGain += fInc;
+					pfBuf++;
+				}while ( pfBuf < pfEnd );
+			}
+		}
+
+		/// Single channel, out-of-place interpolating gain, AKSIMD_V8F32 implementation (do not call directly) use ApplyGain instead.
+		static inline AKSIMD_V8F32_FUNC void ApplyGainRampV8F32(	
+			AkSampleType * AK_RESTRICT in_pfBufferIn, 
+			AkSampleType * AK_RESTRICT out_pfBufferOut, 
+			AkReal32 in_fCurGain,
+			AkReal32 in_fTargetGain,
+			AkUInt32 in_uNumFrames )
+		{
+			AkSampleType * AK_RESTRICT pfInBuf = (AkSampleType * ) in_pfBufferIn;
+			AkSampleType * AK_RESTRICT pfOutBuf = (AkSampleType * ) out_pfBufferOut;
+			const AkSampleType * const pfEnd = pfInBuf + in_uNumFrames;
+
+			const AkUInt32 uNumVecIter = in_uNumFrames/8;
+			if(uNumVecIter)
+			{
+				CAkVectorValueRampV8 vGainRamp;
+				AKSIMD_V8F32 vfGain = vGainRamp.Setup(in_fCurGain,in_fTargetGain,in_uNumFrames);	
+				const AkSampleType * const pfVecEnd = in_pfBufferIn + uNumVecIter*8;
+				while ( pfInBuf < pfVecEnd )
+				{
+					AKSIMD_V8F32 vfIn = AKSIMD_LOADU_V8F32(pfInBuf);
+					AKSIMD_V8F32 vfOut = AKSIMD_MUL_V8F32( vfIn, vfGain );
+					AKSIMD_STOREU_V8F32( pfOutBuf, vfOut );
+					vfGain = vGainRamp.Tick();
+					pfInBuf+=8;
+					pfOutBuf+=8;
+				}
+			}
+
+			if ( pfInBuf < pfEnd )
+			{
+				// Continue the ramp from the gain reached by the vector loop.
+				const AkReal32 fInc = (in_fTargetGain - in_fCurGain) / in_uNumFrames;
+				in_fCurGain += fInc * (AkReal32)( uNumVecIter*8 );
+				do
+				{
+					*pfOutBuf++ = (AkSampleType)(*pfInBuf++ * in_fCurGain);
+					in_fCurGain += fInc;
+				}while ( pfInBuf < pfEnd );
+			}
+		}
+
+		/// Single channel, in-place static gain, AKSIMD_V8F32 implementation (do not call directly) use ApplyGain instead.
+		static inline AKSIMD_V8F32_FUNC void ApplyGainV8F32(	
+			AkSampleType * AK_RESTRICT io_pfBuffer, 
+			AkReal32 in_fGain,
+			AkUInt32 in_uNumFrames )
+		{
+			AkSampleType * AK_RESTRICT pfBuf = (AkSampleType * ) io_pfBuffer;
+			const AkSampleType * const pfEnd = io_pfBuffer + in_uNumFrames;
+
+			// Unroll 2 times x 8 floats
+			const AkUInt32 uNumVecIter = in_uNumFrames/16;
+			if(uNumVecIter)
+			{
+				const AkSampleType * const pfVecEnd = io_pfBuffer + uNumVecIter*16;
+				const AKSIMD_V8F32 vfGain = AKSIMD_LOAD1_V8F32( in_fGain );
+				while ( pfBuf < pfVecEnd )
+				{
+					AKSIMD_V8F32 vfIn1 = AKSIMD_LOADU_V8F32(pfBuf);
+					AKSIMD_V8F32 vfIn2 = AKSIMD_LOADU_V8F32(pfBuf+8);
+					AKSIMD_STOREU_V8F32( pfBuf, AKSIMD_MUL_V8F32( vfIn1, vfGain ) );
+					AKSIMD_STOREU_V8F32( pfBuf+8, AKSIMD_MUL_V8F32( vfIn2, vfGain ) );
+					pfBuf+=16;
+				}
+			}
+
+			while ( pfBuf < pfEnd )
+			{
+				*pfBuf = (AkSampleType)(*pfBuf * in_fGain);
+				pfBuf++;
+			}
+		}
+
+		/// Single channel, out-of-place static gain, AKSIMD_V8F32 implementation (do not call directly) use ApplyGain instead.
+		static inline AKSIMD_V8F32_FUNC void ApplyGainV8F32(	
+			AkSampleType * AK_RESTRICT in_pfBufferIn, 
+			AkSampleType * AK_RESTRICT out_pfBufferOut, 
+			AkReal32 in_fGain,
+			AkUInt32 in_uNumFrames )
+		{
+			AkSampleType * AK_RESTRICT pfInBuf = (AkSampleType * ) in_pfBufferIn;
+			AkSampleType * AK_RESTRICT pfOutBuf = (AkSampleType * ) out_pfBufferOut;
+			const AkSampleType * const pfEnd = in_pfBufferIn + in_uNumFrames;
+
+			// Unroll 2 times x 8 floats
+			const AkUInt32 uNumVecIter = in_uNumFrames/16;
+			if(uNumVecIter)
+			{
+				const AkSampleType * const pfVecEnd = in_pfBufferIn + uNumVecIter*16;
+				const AKSIMD_V8F32 vfGain = AKSIMD_LOAD1_V8F32( in_fGain );
+				while ( pfInBuf < pfVecEnd )
+				{
+					AKSIMD_V8F32 vfIn1 = AKSIMD_LOADU_V8F32(pfInBuf);
+					AKSIMD_V8F32 vfIn2 = AKSIMD_LOADU_V8F32(pfInBuf+8);
+					AKSIMD_STOREU_V8F32( pfOutBuf, AKSIMD_MUL_V8F32( vfIn1, vfGain ) );
+					AKSIMD_STOREU_V8F32( pfOutBuf+8, AKSIMD_MUL_V8F32( vfIn2, vfGain ) );
+					pfInBuf+=16;
+					pfOutBuf+=16;
+				}
+			}
+
+			while ( pfInBuf < pfEnd )
+			{
+				*pfOutBuf++ = (AkSampleType)(*pfInBuf++ * in_fGain);
+			}
+		}
+
+		/// Single channel, accumulating (possibly interpolating) gain, AKSIMD_V8F32 implementation (do not call directly) use MixGain instead.
+		static inline AKSIMD_V8F32_FUNC void MixGainV8F32(	
+			AkSampleType * AK_RESTRICT in_pfBufferIn, 
+			AkSampleType * AK_RESTRICT io_pfBufferOut, 
+			AkReal32 in_fCurGain,
+			AkReal32 in_fTargetGain,
+			AkUInt32 in_uNumFrames )
+		{
+			AkSampleType * AK_RESTRICT pfInBuf = (AkSampleType * ) in_pfBufferIn;
+			AkSampleType * AK_RESTRICT pfOutBuf = (AkSampleType * ) io_pfBufferOut;
+			const AkSampleType * const pfEnd = pfInBuf + in_uNumFrames;
+
+			const AkUInt32 uNumVecIter = in_uNumFrames/8;
+			if(uNumVecIter)
+			{
+				CAkVectorValueRampV8 vGainRamp;
+				AKSIMD_V8F32 vfGain = vGainRamp.Setup(in_fCurGain,in_fTargetGain,in_uNumFrames);	
+				const AkSampleType * const pfVecEnd = in_pfBufferIn + uNumVecIter*8;
+				while ( pfInBuf < pfVecEnd )
+				{
+					AKSIMD_V8F32 vfIn = AKSIMD_LOADU_V8F32(pfInBuf);
+					AKSIMD_V8F32 vfOut = AKSIMD_LOADU_V8F32(pfOutBuf);
+					AKSIMD_STOREU_V8F32( pfOutBuf, AKSIMD_MADD_V8F32( vfIn, vfGain, vfOut ) );
+					vfGain = vGainRamp.Tick();
+					pfInBuf+=8;
+					pfOutBuf+=8;
+				}
+			}
+
+			if ( pfInBuf < pfEnd )
+			{
+				// Continue the ramp from the gain reached by the vector loop.
+				const AkReal32 fInc = (in_fTargetGain - in_fCurGain) / in_uNumFrames;
+				in_fCurGain += fInc * (AkReal32)( uNumVecIter*8 );
+				do
+				{
+					*pfOutBuf++ += (AkSampleType)(*pfInBuf++ * in_fCurGain);
+					in_fCurGain += fInc;
+				}while ( pfInBuf < pfEnd );
+			}
+		}
+#endif
+
 		/// Single channel, in-place interpolating gain helper (do not call directly) use ApplyGain instead.
 		static inline void ApplyGainRamp(	
 			AkSampleType * AK_RESTRICT io_pfBuffer, 
@@ -51,6 +243,13 @@ namespace AK
 			AkReal32 in_fTargetGain,
 			AkUInt32 in_uNumFrames )
 		{
+#ifdef AKSIMD_V8F32_SUPPORTED
+			if ( AKSIMD_V8F32_ENABLED() )
+			{
+				ApplyGainRampV8F32( io_pfBuffer, in_fCurGain, in_fTargetGain, in_uNumFrames );
+				return;
+			}
+#endif
 			AkSampleType * AK_RESTRICT pfBuf = (AkSampleType *) io_pfBuffer;
 			const AkSampleType * const pfEnd = io_pfBuffer + in_uNumFrames;
 
@@ -135,6 +334,13 @@ namespace AK
 			AkReal32 in_fTargetGain,
 			AkUInt32 in_uNumFrames )
 		{
+#ifdef AKSIMD_V8F32_SUPPORTED
+			if ( AKSIMD_V8F32_ENABLED() )
+			{
+				ApplyGainRampV8F32( in_pfBufferIn, out_pfBufferOut, in_fCurGain, in_fTargetGain, in_uNumFrames );
+				return;
+			}
+#endif
 			AkSampleType * AK_RESTRICT pfInBuf = (AkSampleType * ) in_pfBufferIn;
 			AkSampleType * AK_RESTRICT pfOutBuf = (AkSampleType * ) out_pfBufferOut;
 			const AkSampleType * const pfEnd = pfInBuf + in_uNumFrames;
@@ -193,6 +399,13 @@ namespace AK
 		{
 			if ( in_fGain != 1.f )
 			{
+#ifdef AKSIMD_V8F32_SUPPORTED
+				if ( AKSIMD_V8F32_ENABLED() )
+				{
+					ApplyGainV8F32( io_pfBuffer, in_fGain, in_uNumFrames );
+					return;
+				}
+#endif
 				AkSampleType * AK_RESTRICT pfBuf = (AkSampleType * ) io_pfBuffer;
 				const AkSampleType * const pfEnd = io_pfBuffer + in_uNumFrames;
 
@@ -262,6 +475,13 @@ namespace AK
 			AkReal32 in_fGain,
 			AkUInt32 in_uNumFrames )
 		{
+#ifdef AKSIMD_V8F32_SUPPORTED
+			if ( AKSIMD_V8F32_ENABLED() )
+			{
+				ApplyGainV8F32( in_pfBufferIn, out_pfBufferOut, in_fGain, in_uNumFrames );
+				return;
+			}
+#endif
 			AkSampleType * AK_RESTRICT pfInBuf = (AkSampleType * ) in_pfBufferIn;
 			AkSampleType * AK_RESTRICT pfOutBuf = (AkSampleType * ) out_pfBufferOut;
 			const AkSampleType * const pfEnd = in_pfBufferIn + in_uNumFrames;
@@ -355,6 +575,54 @@ namespace AK
 				ApplyGainRamp( in_pfBufferIn, out_pfBufferOut, in_fCurGain, in_fTargetGain, in_uNumFrames );
 		}
 
+		/// Single channel, out-of-place accumulating (possibly interpolating) gain: io_pfBufferOut += in_pfBufferIn * gain.
+		static inline void MixGain(	
+			AkSampleType * AK_RESTRICT in_pfBufferIn, 
+			AkSampleType * AK_RESTRICT io_pfBufferOut, 
+			AkReal32 in_fCurGain,
+			AkReal32 in_fTargetGain,
+			AkUInt32 in_uNumFrames )
+		{
+#ifdef AKSIMD_V8F32_SUPPORTED
+			if ( AKSIMD_V8F32_ENABLED() )
+			{
+				MixGainV8F32( in_pfBufferIn, io_pfBufferOut, in_fCurGain, in_fTargetGain, in_uNumFrames );
+				return;
+			}
+#endif
+			AkSampleType * AK_RESTRICT pfInBuf = (AkSampleType * ) in_pfBufferIn;
+			AkSampleType * AK_RESTRICT pfOutBuf = (AkSampleType * ) io_pfBufferOut;
+			const AkSampleType * const pfEnd = pfInBuf + in_uNumFrames;
+
+#ifdef AKSIMD_V4F32_SUPPORTED
+			const AkUInt32 uNumVecIter = in_uNumFrames/4;
+			if(uNumVecIter)
+			{
+				CAkVectorValueRamp vGainRamp;
+				AKSIMD_V4F32 vfGain = vGainRamp.Setup(in_fCurGain,in_fTargetGain,uNumVecIter*4);	
+				const AkSampleType * const pfVecEnd = in_pfBufferIn + uNumVecIter*4;
+				while ( pfInBuf < pfVecEnd )
+				{
+					AKSIMD_V4F32 vfIn = AKSIMD_LOAD_V4F32((AKSIMD_F32*)pfInBuf);
+					AKSIMD_V4F32 vfOut = AKSIMD_LOAD_V4F32((AKSIMD_F32*)pfOutBuf);
+					AKSIMD_STORE_V4F32( (AKSIMD_F32*)pfOutBuf, AKSIMD_MADD_V4F32( vfIn, vfGain, vfOut ) );
+					vfGain = vGainRamp.Tick();
+					pfInBuf+=4;
+					pfOutBuf+=4;
+				}
+			}
+#endif
+			if ( pfInBuf < pfEnd )
+			{
+				const AkReal32 fInc = (in_fTargetGain - in_fCurGain) / in_uNumFrames;
+				do
+				{
+					*pfOutBuf++ += (AkSampleType)(*pfInBuf++ * in_fCurGain);
+					in_fCurGain += fInc;
+				}while ( pfInBuf < pfEnd );
+			}
+		}
+
 		/// Multi-channel in-place (possibly interpolating) gain.
 		static inline void ApplyGain( 
 			AkAudioBuffer * io_pBuffer,
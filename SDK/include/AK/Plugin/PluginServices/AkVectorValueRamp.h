@@ -93,6 +93,38 @@ private:
 };
 #endif
 
+#ifdef AKSIMD_V8F32_SUPPORTED
+/// Tool for computing a ramp using SIMD types.
+/// Implementation using AKSIMD_V8F32. Only use from AKSIMD_V8F32_FUNC functions.
+class CAkVectorValueRampV8
+{
+public:
+
+	AKSIMD_V8F32_FUNC AkForceInline AKSIMD_V8F32 Setup( AkReal32 in_fStartValue, AkReal32 in_fStopValue, AkUInt32 in_uNumFrames )
+	{
+		const AkReal32 fIncrement = (in_fStopValue-in_fStartValue)/in_uNumFrames;
+		const AkReal32 f8xInc = 8.f*fIncrement;
+		vIncrement = AKSIMD_LOAD1_V8F32( f8xInc );
+		AkReal32 fVal[8];
+		fVal[0] = in_fStartValue;
+		for ( AkUInt32 i = 1; i < 8; i++ )
+			fVal[i] = fVal[i-1] + fIncrement;
+		vValueRamp = AKSIMD_LOADU_V8F32( fVal );
+		return vValueRamp;
+	}
+
+	AKSIMD_V8F32_FUNC AkForceInline AKSIMD_V8F32 Tick( )
+	{
+		vValueRamp = AKSIMD_ADD_V8F32( vValueRamp, vIncrement );
+		return vValueRamp;
+	}
+
+private:
+	AKSIMD_V8F32 vIncrement;
+	AKSIMD_V8F32 vValueRamp;
+};
+#endif
+
 // By default, CAkVectorValueRamp uses the V4 implementation.
 typedef CAkVectorValueRampV4 CAkVectorValueRamp;
 
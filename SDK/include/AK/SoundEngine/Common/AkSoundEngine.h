@@ -38,6 +38,7 @@ the specific language governing permissions and limitations under the License.
 #include <AK/SoundEngine/Common/AkTypes.h>
 #include <AK/SoundEngine/Common/IAkPlugin.h>
 #include <AK/SoundEngine/Common/AkCallback.h>
+#include <AK/Tools/Common/AkFNVHash.h>
 
 #ifdef AK_WIN
 #include <AK/SoundEngine/Platforms/Windows/AkWinSoundEngine.h>
@@ -569,6 +570,23 @@ namespace AK
 		/// - <tt>AK::SoundEngine::PrepareGameSyncs</tt>
 		AK_EXTERNAPIFUNC( AkUInt32, GetIDFromString )( const char* in_pszString );
 
+		/// Batched converter from strings to IDs for the sound engine.
+		/// Produces the same IDs as GetIDFromString(), but hashes several strings at once, one per SIMD lane when the platform supports it.
+		/// Prefer it to repeated calls of GetIDFromString() when resolving many names, for example when loading a level.
+		/// To convert string literals at compile time instead, use <tt>AK::ShortIDFromString()</tt> (see AkFNVHash.h).
+		/// This is an inline wrapper of <tt>AK::ShortIDsFromStrings()</tt>; it does not call into the sound engine.
+		/// \sa
+		/// - <tt>AK::SoundEngine::GetIDFromString</tt>
+		/// - <tt>AK::ShortIDsFromStrings</tt>
+		inline void GetIDsFromStrings(
+			const char* const *	in_ppszStrings,		///< Array of in_uNumStrings strings to convert
+			AkUInt32			in_uNumStrings,		///< Number of strings
+			AkUInt32 *			out_pIDs			///< Returned IDs, array of in_uNumStrings elements
+			)
+		{
+			AK::ShortIDsFromStrings( in_ppszStrings, in_uNumStrings, out_pIDs );
+		}
+
 		//@}
 
 		////////////////////////////////////////////////////////////////////////
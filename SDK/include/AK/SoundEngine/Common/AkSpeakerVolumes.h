@@ -39,6 +39,7 @@ the specific language governing permissions and limitations under the License.
 
 #include <AK/SoundEngine/Common/AkTypes.h>
 #include <AK/Tools/Common/AkPlatformFuncs.h>
+#include <AK/SoundEngine/Common/AkSimd.h>
 #include <AK/SoundEngine/Platforms/Generic/AkSpeakerVolumes.h>
 
 namespace AK
@@ -182,11 +183,55 @@ namespace SpeakerVolumes
 				memcpy( in_pVolumesDst, in_pVolumesSrc, uNumElements * sizeof( AkReal32 ) );
 		}
 
+#ifdef AKSIMD_V8F32_SUPPORTED
+		/// Copy matrix elements with gain, AKSIMD_V8F32 implementation (do not call directly) use Copy instead.
+		AKSIMD_V8F32_FUNC inline void CopyV8F32( AkReal32 * in_pVolumesDst, const AkReal32 * in_pVolumesSrc, AkUInt32 in_uNumElements, AkReal32 in_fGain )
+		{
+			const AkUInt32 uNumVec = in_uNumElements & ~7;
+			const AKSIMD_V8F32 vfGain = AKSIMD_LOAD1_V8F32( in_fGain );
+			AkUInt32 uElem = 0;
+			for ( ; uElem < uNumVec; uElem += 8 )
+				AKSIMD_STOREU_V8F32( in_pVolumesDst + uElem, AKSIMD_MUL_V8F32( AKSIMD_LOADU_V8F32( in_pVolumesSrc + uElem ), vfGain ) );
+			for ( ; uElem < in_uNumElements; uElem++ )
+				in_pVolumesDst[uElem] = in_pVolumesSrc[uElem] * in_fGain;
+		}
+
+		/// Multiply matrix elements with a scalar, AKSIMD_V8F32 implementation (do not call directly) use Mul instead.
+		AKSIMD_V8F32_FUNC inline void MulV8F32( AkReal32 * in_pVolumesDst, AkReal32 in_fVol, AkUInt32 in_uNumElements )
+		{
+			const AkUInt32 uNumVec = in_uNumElements & ~7;
+			const AKSIMD_V8F32 vfVol = AKSIMD_LOAD1_V8F32( in_fVol );
+			AkUInt32 uElem = 0;
+			for ( ; uElem < uNumVec; uElem += 8 )
+				AKSIMD_STOREU_V8F32( in_pVolumesDst + uElem, AKSIMD_MUL_V8F32( AKSIMD_LOADU_V8F32( in_pVolumesDst + uElem ), vfVol ) );
+			for ( ; uElem < in_uNumElements; uElem++ )
+				in_pVolumesDst[uElem] *= in_fVol;
+		}
+
+		/// Add matrix elements, AKSIMD_V8F32 implementation (do not call directly) use Add instead.
+		AKSIMD_V8F32_FUNC inline void AddV8F32( AkReal32 * in_pVolumesDst, const AkReal32 * in_pVolumesSrc, AkUInt32 in_uNumElements )
+		{
+			const AkUInt32 uNumVec = in_uNumElements & ~7;
+			AkUInt32 uElem = 0;
+			for ( ; uElem < uNumVec; uElem += 8 )
+				AKSIMD_STOREU_V8F32( in_pVolumesDst + uElem, AKSIMD_ADD_V8F32( AKSIMD_LOADU_V8F32( in_pVolumesDst + uElem ), AKSIMD_LOADU_V8F32( in_pVolumesSrc + uElem ) ) );
+			for ( ; uElem < in_uNumElements; uElem++ )
+				in_pVolumesDst[uElem] += in_pVolumesSrc[uElem];
+		}
+#endif
+
 		/// Copy matrix with gain.
 		AkForceInline void Copy( MatrixPtr in_pVolumesDst, ConstMatrixPtr in_pVolumesSrc, AkUInt32 in_uNumChannelsIn, AkUInt32 in_uNumChannelsOut, AkReal32 in_fGain )
 		{
 			AkUInt32 uNumElements = Matrix::GetNumElements( in_uNumChannelsIn, in_uNumChannelsOut );
 			AKASSERT( ( in_pVolumesDst && in_pVolumesSrc ) || uNumElements == 0 );
+#ifdef AKSIMD_V8F32_SUPPORTED
+			if ( AKSIMD_V8F32_ENABLED() )
+			{
+				CopyV8F32( in_pVolumesDst, in_pVolumesSrc, uNumElements, in_fGain );
+				return;
+			}
+#endif
 			for ( AkUInt32 uChan = 0; uChan < uNumElements; uChan++ )
 			{
 				in_pVolumesDst[uChan] = in_pVolumesSrc[uChan] * in_fGain;
@@ -207,6 +252,13 @@ namespace SpeakerVolumes
 		{
 			AkUInt32 uNumElements = Matrix::GetNumElements( in_uNumChannelsIn, in_uNumChannelsOut );
 			AKASSERT( in_pVolumesDst || uNumElements == 0 );
+#ifdef AKSIMD_V8F32_SUPPORTED
+			if ( AKSIMD_V8F32_ENABLED() )
+			{
+				MulV8F32( in_pVolumesDst, in_fVol, uNumElements );
+				return;
+			}
+#endif
 			for ( AkUInt32 uChan = 0; uChan < uNumElements; uChan++ )
 			{
 				in_pVolumesDst[uChan] *= in_fVol;
@@ -218,6 +270,13 @@ namespace SpeakerVolumes
 		{
 			AkUInt32 uNumElements = Matrix::GetNumElements(in_uNumChannelsIn, in_uNumChannelsOut);
 			AKASSERT((in_pVolumesDst && in_pVolumesSrc) || uNumElements == 0);
+#ifdef AKSIMD_V8F32_SUPPORTED
+			if ( AKSIMD_V8F32_ENABLED() )
+			{
+				AddV8F32( in_pVolumesDst, in_pVolumesSrc, uNumElements );
+				return;
+			}
+#endif
 			for (AkUInt32 uChan = 0; uChan < uNumElements; uChan++)
 			{
 				in_pVolumesDst[uChan] += in_pVolumesSrc[uChan];
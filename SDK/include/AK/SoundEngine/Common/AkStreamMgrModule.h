@@ -90,6 +90,12 @@ struct AkDeviceSettings
 /// The streaming device expects a deferred I/O hook at creation time (IAkIOHookDeferred interface, see CreateDevice()). 
 /// Up to AkDeviceSettings::uMaxConcurrentIO requests can be sent to the Low-Level I/O at the same time.
 #define AK_SCHEDULER_DEFERRED_LINED_UP (0x02)
+/// Modifier of AK_SCHEDULER_BLOCKING and AK_SCHEDULER_DEFERRED_LINED_UP: automatic streams are scheduled earliest deadline first.
+/// The deadline of a stream is the time at which it will have consumed its buffered and requested data, computed from 
+/// AkAutoStmHeuristics::fThroughput; priority only breaks ties. The deadline is passed to the Low-Level I/O in AkIoHeuristics::fDeadline, 
+/// so that deferred hooks can keep pending transfers in the same order (see AkDeadlineQueue.h and CAkIoUringIOHook).
+/// Use it when many streams compete for a device that cannot keep all of them at their target buffering.
+#define AK_SCHEDULER_DEADLINE_FIRST    (0x04)
 
 /// File descriptor. File identification for the low-level I/O.
 /// \sa
@@ -153,7 +159,7 @@ struct AkAsyncIOTransferInfo : public AkIOTransferInfo
 /// - AK::StreamMgr::IAkIOHookDeferred::Write()
 struct AkIoHeuristics
 {
-	AkReal32		fDeadline;			///< Operation deadline (ms). 
+	AkReal32		fDeadline;			///< Operation deadline (ms): time until the stream runs out of data if the transfer does not complete. 
 	AkPriority		priority;			///< Operation priority (at the time it was scheduled and sent to the Low-Level I/O). Range is [AK_MIN_PRIORITY,AK_MAX_PRIORITY], inclusively.
 };
 
@@ -0,0 +1,963 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkIoUringIOHook.h
+
+/// \file 
+/// Deferred Low-Level I/O hook for Linux, backed by io_uring.
+/// Transfers posted by the streaming device are gathered by a completion thread, ordered by
+/// AkIoHeuristics::fDeadline (earliest first, then highest priority) and submitted to the kernel with a single io_uring_enter() call per batch;
+/// the same call reaps completed transfers. Files are opened for reading only, optionally with O_DIRECT to bypass the page cache.
+/// Reads of the same file that are contiguous, or separated by at most a small gap, are merged into a single 
+/// vectored read (IORING_OP_READV); each transfer is then completed individually. Gaps are read into a scratch buffer.
+/// Requires Linux 5.1 or later; no dependency on liburing.
+/// 
+/// Usage: 
+/// - Initialize with AK_SCHEDULER_DEFERRED_LINED_UP device settings, optionally with AK_SCHEDULER_DEADLINE_FIRST. When using O_DIRECT, 
+/// AkDeviceSettings::uGranularity and AkDeviceSettings::uIOMemoryAlignment must be multiples of the block size.
+/// - Resolve file names in your AK::StreamMgr::IAkFileLocationResolver, and open them with CAkIoUringIOHook::Open().
+/// Open() stores AK_IOURING_FILE_* flags in AkFileDesc::uCustomParamSize and sets AkFileDesc::pCustomParam to NULL. Resolvers that 
+/// derive descriptors from a file opened by the hook (e.g. file packages) must preserve uCustomParamSize, and set pCustomParam 
+/// to any non-NULL value: such descriptors share the handle of their file, which Close() leaves open.
+
+#pragma once
+
+#include <AK/SoundEngine/Common/AkStreamMgrModule.h>
+#include <AK/Tools/Common/AkArray.h>
+#include <AK/Tools/Common/AkAtomic.h>
+#include <AK/Tools/Common/AkDeadlineQueue.h>
+#include <AK/Tools/Common/AkLock.h>
+#include <AK/Tools/Common/AkAutoLock.h>
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <time.h>
+
+#define AK_IOURING_DEFAULT_BLOCK_SIZE	(4096)	///< Default O_DIRECT block size, suitable for most file systems and devices.
+#define AK_IOURING_DEFAULT_MAX_MERGE_GAP	(16384)	///< Default largest hole between two reads that are merged. Multiple of AK_IOURING_DEFAULT_BLOCK_SIZE.
+#define AK_IOURING_MAX_MERGED_IOVECS	(16)	///< Maximum number of buffers (transfers and gaps) in a merged read.
+
+#define AK_IOURING_FILE_DIRECT_IO		(0x1)	///< AkFileDesc::uCustomParamSize flag: the file was opened with O_DIRECT.
+
+/// Receives the transfers of a CAkIoUringIOHook, from their reception to their completion (see CAkIoUringIOHook::SetTransferListener()).
+/// The signatures match those of CAkStreamTraceRecorder, so that an implementation can simply forward to a trace recorder.
+class IAkIoUringTransferListener
+{
+protected:
+	virtual ~IAkIoUringTransferListener() {}
+
+public:
+	/// Called when the hook receives a transfer, from the thread of the streaming device. in_pTransfer identifies the transfer until OnTransferEnd().
+	virtual void OnTransferBegin( 
+		AkDeviceID in_deviceID,							///< Device of the transfer
+		const void * in_pTransfer,						///< AkAsyncIOTransferInfo of the transfer
+		AkUInt64 in_uFilePosition,						///< Position in the file, in bytes
+		AkUInt32 in_uSize,								///< Requested size, in bytes
+		AkPriority in_priority,							///< AkIoHeuristics::priority
+		AkReal32 in_fDeadline							///< AkIoHeuristics::fDeadline, in ms
+		) = 0;
+
+	/// Called from the completion thread, before the transfer is called back.
+	virtual void OnTransferEnd( 
+		AkDeviceID in_deviceID,							///< Device of the transfer
+		const void * in_pTransfer,						///< Transfer passed to OnTransferBegin()
+		AKRESULT in_eResult								///< Result passed to the Stream Manager
+		) = 0;
+};
+
+/// Deferred Low-Level I/O hook backed by io_uring.
+/// Cancel() cancels transfers that were not submitted yet, and asks the kernel to cancel those in flight (IORING_OP_ASYNC_CANCEL).
+/// Completion callbacks, including those of cancelled transfers, are always called from the hook's completion thread.
+class CAkIoUringIOHook : public AK::StreamMgr::IAkIOHookDeferred
+{
+public:
+	CAkIoUringIOHook()
+		: m_pFree( NULL )
+		, m_pCancelQueue( NULL )
+		, m_deviceID( AK_INVALID_DEVICE_ID )
+		, m_uBlockSize( AK_IOURING_DEFAULT_BLOCK_SIZE )
+		, m_uMaxMergeGap( 0 )
+		, m_pGapBuffer( NULL )
+		, m_pTransferListener( NULL )
+		, m_iRingFd( -1 )
+		, m_iEventFd( -1 )
+		, m_pSqRing( NULL )
+		, m_pCqRing( NULL )
+		, m_pSqes( NULL )
+		, m_uSqRingSize( 0 )
+		, m_uCqRingSize( 0 )
+		, m_uSqesSize( 0 )
+		, m_iNumInFlight( 0 )
+		, m_uNumToSubmit( 0 )
+		, m_iNumSubmitCalls( 0 )
+		, m_iNumTransfers( 0 )
+		, m_iNumCancelled( 0 )
+		, m_iNumMergedTransfers( 0 )
+		, m_iNumMergedBytes( 0 )
+		, m_iNumGapBytes( 0 )
+		, m_iNumDeadlineMisses( 0 )
+		, m_bDirectIO( false )
+		, m_bWakeupPending( false )
+		, m_bRearmWakeup( false )
+		, m_bStop( false )
+	{
+		AKPLATFORM::AkClearThread( &m_hThread );
+	}
+
+	virtual ~CAkIoUringIOHook()
+	{
+		AKASSERT( m_iRingFd < 0 || !"Term() was not called" );
+	}
+
+	/// Creates the io_uring instance, its completion thread and the streaming device.
+	/// \return AK_Success, AK_InsufficientMemory, or AK_Fail if the device settings are invalid or io_uring is not available.
+	AKRESULT Init(
+		const AkDeviceSettings & in_deviceSettings,						///< Device settings. uSchedulerTypeFlags must be AK_SCHEDULER_DEFERRED_LINED_UP, optionally with AK_SCHEDULER_DEADLINE_FIRST; threadProperties are used for the completion thread.
+		bool in_bUseDirectIO = true,									///< Open files with O_DIRECT (falls back to buffered I/O on file systems that do not support it).
+		AkUInt32 in_uBlockSize = AK_IOURING_DEFAULT_BLOCK_SIZE,			///< Block size of O_DIRECT files; power of 2.
+		AkUInt32 in_uMaxMergeGap = AK_IOURING_DEFAULT_MAX_MERGE_GAP		///< Largest hole, in bytes, between two reads that are merged. 0 merges contiguous reads only. Multiple of in_uBlockSize.
+		)
+	{
+		// Pending transfers are always ordered by deadline, so the modifier needs no special handling here.
+		if ( ( in_deviceSettings.uSchedulerTypeFlags & ~AK_SCHEDULER_DEADLINE_FIRST ) != AK_SCHEDULER_DEFERRED_LINED_UP )
+		{
+			AKASSERT( !"CAkIoUringIOHook requires AK_SCHEDULER_DEFERRED_LINED_UP" );
+			return AK_Fail;
+		}
+		AKASSERT( in_uBlockSize && ( in_uBlockSize & ( in_uBlockSize - 1 ) ) == 0 );
+		AKASSERT( !in_bUseDirectIO || ( in_deviceSettings.uGranularity % in_uBlockSize == 0 && in_deviceSettings.uIOMemoryAlignment % in_uBlockSize == 0 ) );
+
+		m_bDirectIO = in_bUseDirectIO;
+		m_uBlockSize = in_uBlockSize;
+		m_bStop = false;
+
+		AKASSERT( in_uMaxMergeGap % in_uBlockSize == 0 );
+		m_uMaxMergeGap = 0;
+		if ( in_uMaxMergeGap )
+		{
+			// Data between merged reads is discarded; all gaps may share the same buffer.
+			m_pGapBuffer = AkMalign( g_DefaultPoolId, in_uMaxMergeGap, in_uBlockSize );
+			if ( !m_pGapBuffer )
+			{
+				Term();
+				return AK_InsufficientMemory;
+			}
+			m_uMaxMergeGap = in_uMaxMergeGap;
+		}
+
+		const AkUInt32 uNumRequests = AkMax( in_deviceSettings.uMaxConcurrentIO, 1 );
+		if ( !m_requests.Resize( uNumRequests ) || m_pending.Reserve( uNumRequests ) != AK_Success )
+		{
+			Term();
+			return AK_InsufficientMemory;
+		}
+		m_pFree = NULL;
+		for ( AkUInt32 i = uNumRequests; i > 0; --i )
+		{
+			Request & req = m_requests[i-1];
+			req.pTransferInfo = NULL;
+			req.uIndex = i - 1;
+			req.uGeneration = 0;
+			req.bCancelQueued = false;
+			req.pNextItem = m_pFree;
+			m_pFree = &req;
+		}
+
+		// Each transfer may have a cancel operation in flight, plus the wake-up poll.
+		if ( SetupRing( uNumRequests * 2 + 1 ) != AK_Success )
+		{
+			Term();
+			return AK_Fail;
+		}
+
+		m_iEventFd = eventfd( 0, EFD_CLOEXEC );
+		if ( m_iEventFd < 0 )
+		{
+			Term();
+			return AK_Fail;
+		}
+		m_bRearmWakeup = true;
+
+		AKPLATFORM::AkCreateThread( IoThread, this, in_deviceSettings.threadProperties, &m_hThread, "AK::IoUringIOHook" );
+		if ( !AKPLATFORM::AkIsValidThread( &m_hThread ) )
+		{
+			Term();
+			return AK_Fail;
+		}
+
+		m_deviceID = AK::StreamMgr::CreateDevice( in_deviceSettings, this );
+		if ( m_deviceID == AK_INVALID_DEVICE_ID )
+		{
+			Term();
+			return AK_Fail;
+		}
+		return AK_Success;
+	}
+
+	/// Destroys the streaming device, then stops the completion thread and releases the ring.
+	void Term()
+	{
+		if ( m_deviceID != AK_INVALID_DEVICE_ID )
+		{
+			AK::StreamMgr::DestroyDevice( m_deviceID );
+			m_deviceID = AK_INVALID_DEVICE_ID;
+		}
+
+		if ( AKPLATFORM::AkIsValidThread( &m_hThread ) )
+		{
+			{
+				AkAutoLock<CAkLock> lock( m_lock );
+				m_bStop = true;
+			}
+			Wakeup();
+			AKPLATFORM::AkWaitForSingleThread( &m_hThread );
+			AKPLATFORM::AkCloseThread( &m_hThread );
+		}
+
+		if ( m_iEventFd >= 0 )
+		{
+			close( m_iEventFd );
+			m_iEventFd = -1;
+		}
+		TermRing();
+
+		m_pFree = NULL;
+		m_pCancelQueue = NULL;
+		m_pending.Term();
+		m_requests.Term();
+
+		if ( m_pGapBuffer )
+		{
+			AkFalign( g_DefaultPoolId, m_pGapBuffer );
+			m_pGapBuffer = NULL;
+		}
+		m_uMaxMergeGap = 0;
+	}
+
+	/// Device ID of the streaming device created in Init(), to assign to AkFileDesc::deviceID.
+	inline AkDeviceID GetDeviceID() const { return m_deviceID; }
+
+	/// Opens a file for reading and fills its file descriptor. Call from your AK::StreamMgr::IAkFileLocationResolver::Open().
+	/// \return AK_Success, or AK_FileNotFound.
+	AKRESULT Open(
+		const char * in_pszFilePath,		///< Path of the file to open.
+		AkFileDesc & out_fileDesc			///< Returned file descriptor.
+		)
+	{
+		int iFd = -1;
+		AkUInt32 uFileFlags = 0;
+		if ( m_bDirectIO )
+		{
+			iFd = open( in_pszFilePath, O_RDONLY | O_CLOEXEC | O_DIRECT );
+			if ( iFd >= 0 )
+				uFileFlags = AK_IOURING_FILE_DIRECT_IO;
+		}
+		if ( iFd < 0 )
+			iFd = open( in_pszFilePath, O_RDONLY | O_CLOEXEC );
+		if ( iFd < 0 )
+			return AK_FileNotFound;
+
+		struct stat fileStat;
+		FILE * hFile = NULL;
+		if ( fstat( iFd, &fileStat ) != 0 || ( hFile = fdopen( iFd, "rb" ) ) == NULL )
+		{
+			close( iFd );
+			return AK_FileNotFound;
+		}
+
+		out_fileDesc.iFileSize = fileStat.st_size;
+		out_fileDesc.uSector = 0;
+		out_fileDesc.uCustomParamSize = uFileFlags;
+		out_fileDesc.pCustomParam = NULL;
+		out_fileDesc.hFile = hFile;
+		out_fileDesc.deviceID = m_deviceID;
+		return AK_Success;
+	}
+
+	/// Number of io_uring_enter() calls since Init(). Compare with GetNumTransfers() to get the average submission batch size.
+	inline AkUInt32 GetNumSubmitCalls() const { return (AkUInt32)LoadCounter( m_iNumSubmitCalls ); }
+
+	/// Number of transfers received since Init().
+	inline AkUInt32 GetNumTransfers() const { return (AkUInt32)LoadCounter( m_iNumTransfers ); }
+
+	/// Number of transfers cancelled since Init(), before submission or in flight.
+	inline AkUInt32 GetNumCancelled() const { return (AkUInt32)LoadCounter( m_iNumCancelled ); }
+
+	/// Number of reads that were merged into another transfer's read since Init(), i.e. the number of ring operations saved.
+	inline AkUInt32 GetNumMergedTransfers() const { return (AkUInt32)LoadCounter( m_iNumMergedTransfers ); }
+
+	/// Bytes read on behalf of merged transfers since Init().
+	inline AkUInt64 GetNumMergedBytes() const { return (AkUInt64)LoadCounter( m_iNumMergedBytes ); }
+
+	/// Bytes read into the gap buffer since Init(), to fill holes between merged transfers. This data is discarded.
+	inline AkUInt64 GetNumGapBytes() const { return (AkUInt64)LoadCounter( m_iNumGapBytes ); }
+
+	/// Number of transfers completed after their deadline (AkIoHeuristics::fDeadline after their reception) since Init(). Cancelled transfers are not counted.
+	inline AkUInt32 GetNumDeadlineMisses() const { return (AkUInt32)LoadCounter( m_iNumDeadlineMisses ); }
+
+	/// Reports each transfer, from its reception to its completion, to a listener (e.g. a CAkStreamTraceRecorder adapter). Call before Init() or after Term(). NULL to stop.
+	inline void SetTransferListener( IAkIoUringTransferListener * in_pListener ) { m_pTransferListener = in_pListener; }
+
+	// IAkLowLevelIOHook
+
+	virtual AKRESULT Close( AkFileDesc & in_fileDesc )
+	{
+		// Descriptors derived from another file (e.g. files of a package) share its handle, which is closed by their owner.
+		if ( in_fileDesc.pCustomParam )
+			return AK_Success;
+		return ( fclose( in_fileDesc.hFile ) == 0 ) ? AK_Success : AK_Fail;
+	}
+
+	virtual AkUInt32 GetBlockSize( AkFileDesc & in_fileDesc )
+	{
+		// Only files actually opened with O_DIRECT have alignment constraints.
+		return IsDirectIO( in_fileDesc ) ? m_uBlockSize : 1;
+	}
+
+	virtual void GetDeviceDesc( AkDeviceDesc & out_deviceDesc )
+	{
+		static const char szName[] = "io_uring";
+		out_deviceDesc.deviceID = m_deviceID;
+		out_deviceDesc.bCanRead = true;
+		out_deviceDesc.bCanWrite = false;
+		AkUInt32 uChar = 0;
+		for ( ; szName[uChar] && uChar < AK_MONITOR_DEVICENAME_MAXLENGTH - 1; uChar++ )
+			out_deviceDesc.szDeviceName[uChar] = (AkUtf16)szName[uChar];
+		out_deviceDesc.szDeviceName[uChar] = 0;
+		out_deviceDesc.uStringSize = uChar + 1;
+	}
+
+	/// Returns the number of transfers in flight in the kernel.
+	virtual AkUInt32 GetDeviceData()
+	{
+		return (AkUInt32)AKPLATFORM::AkAtomicLoad32( &m_iNumInFlight, AkMemoryOrder_Relaxed );
+	}
+
+	// IAkIOHookDeferred
+
+	virtual AKRESULT Read(
+		AkFileDesc &			in_fileDesc,
+		const AkIoHeuristics &	in_heuristics,
+		AkAsyncIOTransferInfo & io_transferInfo
+		)
+	{
+		return Enqueue( in_fileDesc, in_heuristics, io_transferInfo );
+	}
+
+	/// Files are opened for reading only (see GetDeviceDesc()).
+	virtual AKRESULT Write(
+		AkFileDesc &			/*in_fileDesc*/,
+		const AkIoHeuristics &	/*in_heuristics*/,
+		AkAsyncIOTransferInfo & /*io_transferInfo*/
+		)
+	{
+		AKASSERT( !"CAkIoUringIOHook does not support writing" );
+		return AK_Fail;
+	}
+
+	virtual void Cancel(
+		AkFileDesc &			/*in_fileDesc*/,
+		AkAsyncIOTransferInfo & io_transferInfo,
+		bool &					io_bCancelAllTransfersForThisFile
+		)
+	{
+		// Cancel transfers one by one; callbacks are deferred to the completion thread.
+		io_bCancelAllTransfersForThisFile = false;
+
+		bool bWakeup = false;
+		{
+			AkAutoLock<CAkLock> lock( m_lock );
+			for ( AkUInt32 i = 0; i < m_requests.Length(); i++ )
+			{
+				Request & req = m_requests[i];
+				if ( req.pTransferInfo != &io_transferInfo || req.bCancelled )
+					continue;
+
+				req.bCancelled = true;
+				AKPLATFORM::AkAtomicFetchAdd32( &m_iNumCancelled, 1, AkMemoryOrder_Relaxed );
+				if ( req.bInFlight && !req.bCancelQueued )
+				{
+					req.pNextCancel = m_pCancelQueue;
+					m_pCancelQueue = &req;
+					req.bCancelQueued = true;
+				}
+				bWakeup = !m_bWakeupPending;
+				m_bWakeupPending = true;
+				break;
+			}
+		}
+		if ( bWakeup )
+			Wakeup();
+	}
+
+private:
+	struct Request
+	{
+		AkAsyncIOTransferInfo *	pTransferInfo;	// NULL when free.
+		Request *				pNextItem;		// Free list, or list of requests cancelled before submission.
+		Request *				pNextCancel;	// Cancel queue. A request may still be queued after being recycled; see bCancelQueued.
+		Request *				pLeader;		// Request whose ring operation carries this transfer; itself when it was not merged.
+		Request *				pNextMerged;	// Next transfer of the same merged read, by increasing file position.
+		Request *				pFirstMerged;	// Leader only: transfer at the lowest file position.
+		AkInt64					iFileSize;
+		AkUInt64				uFileOffset;	// Offset of the file in its handle (AkFileDesc::uSector, in bytes); transfer positions include it.
+		AkUInt64				uPosition;
+		struct iovec			iov;
+		struct iovec			aMergedIov[AK_IOURING_MAX_MERGED_IOVECS];	// Leader only: buffers of the merged read, including gaps.
+		AkUInt32				uNumMergedIov;
+		AkUInt32				uMergedOffset;	// Offset of this transfer in the merged read.
+		AkUInt32				uIndex;
+		AkUInt32				uGeneration;	// Incremented on each use, so that stale cancel operations never match a recycled request.
+		int						iFd;
+		AkReal64				fDeadline;		// Absolute, in ms of CLOCK_MONOTONIC.
+		AkPriority				priority;
+		bool					bInFlight;
+		bool					bCancelled;
+		bool					bCancelQueued;
+	};
+
+	// user_data of ring operations. Transfers use ( generation << 32 ) | ( index + 1 ).
+	static const AkUInt64 kWakeupTag = 0;
+	static const AkUInt64 kCancelTag = 0xFFFFFFFF;
+
+	static inline AkUInt64 GetUserData( const Request & in_req )
+	{
+		return ( (AkUInt64)in_req.uGeneration << 32 ) | ( in_req.uIndex + 1 );
+	}
+
+	/// Maps AkIoHeuristics::priority to a best-effort I/O scheduling class level (0 is the highest).
+	static inline AkUInt16 GetIoPrio( AkPriority in_priority )
+	{
+		const AkUInt16 uLevel = (AkUInt16)( 7 - ( ( in_priority - AK_MIN_PRIORITY ) * 7 + 50 ) / ( AK_MAX_PRIORITY - AK_MIN_PRIORITY ) );
+		return (AkUInt16)( ( 2 << 13 ) | uLevel ); // IOPRIO_CLASS_BE
+	}
+
+	// Statistics are written by several threads and read by any thread; they only need atomicity, not ordering.
+	static inline AkInt32 LoadCounter( const AkAtomic32 & in_counter ) { return AKPLATFORM::AkAtomicLoad32( (volatile AkAtomic32*)&in_counter, AkMemoryOrder_Relaxed ); }
+	static inline AkInt64 LoadCounter( const AkAtomic64 & in_counter ) { return AKPLATFORM::AkAtomicLoad64( (volatile AkAtomic64*)&in_counter, AkMemoryOrder_Relaxed ); }
+
+	static inline bool IsDirectIO( const AkFileDesc & in_fileDesc )
+	{
+		return ( in_fileDesc.uCustomParamSize & AK_IOURING_FILE_DIRECT_IO ) != 0;
+	}
+
+	AKRESULT Enqueue(
+		AkFileDesc &			in_fileDesc,
+		const AkIoHeuristics &	in_heuristics,
+		AkAsyncIOTransferInfo & io_transferInfo
+		)
+	{
+		const int iFd = fileno( in_fileDesc.hFile );
+		AkUInt32 uSize = io_transferInfo.uRequestedSize;
+		if ( IsDirectIO( in_fileDesc ) )
+		{
+			// O_DIRECT transfers must span whole blocks; the last block of the file is read short.
+			AKASSERT( ( (AkUIntPtr)io_transferInfo.pBuffer & ( m_uBlockSize - 1 ) ) == 0 );
+			AKASSERT( ( io_transferInfo.uFilePosition & ( m_uBlockSize - 1 ) ) == 0 );
+			uSize = AkMin( ( uSize + m_uBlockSize - 1 ) & ~( m_uBlockSize - 1 ), io_transferInfo.uBufferSize );
+		}
+
+		bool bWakeup;
+		{
+			AkAutoLock<CAkLock> lock( m_lock );
+			Request * pReq = m_pFree;
+			if ( !pReq )
+			{
+				AKASSERT( !"More concurrent transfers than AkDeviceSettings::uMaxConcurrentIO" );
+				return AK_Fail;
+			}
+			m_pFree = pReq->pNextItem;
+
+			pReq->pTransferInfo = &io_transferInfo;
+			pReq->iFileSize = in_fileDesc.iFileSize;
+			pReq->uFileOffset = (AkUInt64)in_fileDesc.uSector * GetBlockSize( in_fileDesc );
+			pReq->uPosition = io_transferInfo.uFilePosition;
+			pReq->iov.iov_base = io_transferInfo.pBuffer;
+			pReq->iov.iov_len = uSize;
+			pReq->uGeneration++;
+			pReq->iFd = iFd;
+			pReq->fDeadline = GetTimeMs() + in_heuristics.fDeadline;
+			pReq->priority = in_heuristics.priority;
+			pReq->bInFlight = false;
+			pReq->bCancelled = false;
+
+			// Deadlines are made absolute, so that transfers posted in different batches compare correctly.
+			// The queue was reserved for all requests in Init(), so this cannot fail.
+			AKVERIFY( m_pending.Push( pReq, pReq->fDeadline, in_heuristics.priority ) );
+
+			AKPLATFORM::AkAtomicFetchAdd32( &m_iNumTransfers, 1, AkMemoryOrder_Relaxed );
+			bWakeup = !m_bWakeupPending;
+			m_bWakeupPending = true;
+
+			// Under the lock, so that the beginning is recorded before the completion thread can complete the transfer.
+			if ( m_pTransferListener )
+				m_pTransferListener->OnTransferBegin( m_deviceID, &io_transferInfo, io_transferInfo.uFilePosition, io_transferInfo.uRequestedSize, in_heuristics.priority, in_heuristics.fDeadline );
+		}
+
+		// One eventfd write per batch: the completion thread gathers everything posted until it wakes up.
+		if ( bWakeup )
+			Wakeup();
+		return AK_Success;
+	}
+
+	static inline AkReal64 GetTimeMs()
+	{
+		struct timespec now;
+		clock_gettime( CLOCK_MONOTONIC, &now );
+		return (AkReal64)now.tv_sec * 1000.0 + (AkReal64)now.tv_nsec / 1000000.0;
+	}
+
+	inline void Wakeup()
+	{
+		const eventfd_t uValue = 1;
+		AKVERIFY( write( m_iEventFd, &uValue, sizeof( uValue ) ) == sizeof( uValue ) );
+	}
+
+	// Completion thread helpers. The submission and completion queues are only accessed by the completion thread.
+
+	AKRESULT SetupRing( AkUInt32 in_uNumEntries )
+	{
+		struct io_uring_params params;
+		AKPLATFORM::AkMemSet( &params, 0, sizeof( params ) );
+		m_iRingFd = (int)syscall( __NR_io_uring_setup, in_uNumEntries, &params );
+		if ( m_iRingFd < 0 )
+			return AK_Fail;
+
+		m_uSqRingSize = params.sq_off.array + params.sq_entries * sizeof( AkUInt32 );
+		m_uCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof( struct io_uring_cqe );
+		if ( params.features & IORING_FEAT_SINGLE_MMAP )
+			m_uSqRingSize = m_uCqRingSize = AkMax( m_uSqRingSize, m_uCqRingSize );
+
+		m_pSqRing = (AkUInt8*)mmap( NULL, m_uSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_iRingFd, IORING_OFF_SQ_RING );
+		if ( m_pSqRing == MAP_FAILED )
+		{
+			m_pSqRing = NULL;
+			return AK_Fail;
+		}
+		if ( params.features & IORING_FEAT_SINGLE_MMAP )
+			m_pCqRing = m_pSqRing;
+		else
+		{
+			m_pCqRing = (AkUInt8*)mmap( NULL, m_uCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_iRingFd, IORING_OFF_CQ_RING );
+			if ( m_pCqRing == MAP_FAILED )
+			{
+				m_pCqRing = NULL;
+				return AK_Fail;
+			}
+		}
+		m_uSqesSize = params.sq_entries * sizeof( struct io_uring_sqe );
+		m_pSqes = (struct io_uring_sqe*)mmap( NULL, m_uSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_iRingFd, IORING_OFF_SQES );
+		if ( m_pSqes == MAP_FAILED )
+		{
+			m_pSqes = NULL;
+			return AK_Fail;
+		}
+
+		m_sq.pHead = (AkUInt32*)( m_pSqRing + params.sq_off.head );
+		m_sq.pTail = (AkUInt32*)( m_pSqRing + params.sq_off.tail );
+		m_sq.pArray = (AkUInt32*)( m_pSqRing + params.sq_off.array );
+		m_sq.uMask = *(AkUInt32*)( m_pSqRing + params.sq_off.ring_mask );
+		m_sq.uEntries = params.sq_entries;
+		m_cq.pHead = (AkUInt32*)( m_pCqRing + params.cq_off.head );
+		m_cq.pTail = (AkUInt32*)( m_pCqRing + params.cq_off.tail );
+		m_cq.pCqes = (struct io_uring_cqe*)( m_pCqRing + params.cq_off.cqes );
+		m_cq.uMask = *(AkUInt32*)( m_pCqRing + params.cq_off.ring_mask );
+		return AK_Success;
+	}
+
+	void TermRing()
+	{
+		if ( m_pSqes )
+			munmap( m_pSqes, m_uSqesSize );
+		if ( m_pCqRing && m_pCqRing != m_pSqRing )
+			munmap( m_pCqRing, m_uCqRingSize );
+		if ( m_pSqRing )
+			munmap( m_pSqRing, m_uSqRingSize );
+		m_pSqes = NULL;
+		m_pCqRing = NULL;
+		m_pSqRing = NULL;
+		if ( m_iRingFd >= 0 )
+		{
+			close( m_iRingFd );
+			m_iRingFd = -1;
+		}
+	}
+
+	/// Gets the next submission queue entry, cleared. The ring is sized so that it never runs out of entries.
+	struct io_uring_sqe * GetSqe()
+	{
+		const AkUInt32 uTail = *m_sq.pTail;
+		AKASSERT( uTail - __atomic_load_n( m_sq.pHead, __ATOMIC_ACQUIRE ) < m_sq.uEntries );
+		const AkUInt32 uIdx = uTail & m_sq.uMask;
+		struct io_uring_sqe * pSqe = &m_pSqes[uIdx];
+		AKPLATFORM::AkMemSet( pSqe, 0, sizeof( struct io_uring_sqe ) );
+		m_sq.pArray[uIdx] = uIdx;
+		return pSqe;
+	}
+
+	inline void CommitSqe()
+	{
+		__atomic_store_n( m_sq.pTail, *m_sq.pTail + 1, __ATOMIC_RELEASE );
+		++m_uNumToSubmit;
+	}
+
+	/// Moves queued work to the submission queue. Returns requests that were cancelled before submission.
+	Request * PrepareSubmissions( bool & out_bStop )
+	{
+		Request * pCancelled = NULL;
+		AkAutoLock<CAkLock> lock( m_lock );
+		out_bStop = m_bStop;
+		m_bWakeupPending = false;
+
+		if ( m_bRearmWakeup )
+		{
+			struct io_uring_sqe * pSqe = GetSqe();
+			pSqe->opcode = IORING_OP_POLL_ADD;
+			pSqe->fd = m_iEventFd;
+			pSqe->poll_events = POLLIN;
+			pSqe->user_data = kWakeupTag;
+			CommitSqe();
+			m_bRearmWakeup = false;
+		}
+
+		while ( m_pCancelQueue )
+		{
+			Request * pReq = m_pCancelQueue;
+			m_pCancelQueue = pReq->pNextCancel;
+			pReq->bCancelQueued = false;
+			// The request may have completed, or even been recycled, since it was queued.
+			if ( !pReq->bInFlight || !pReq->bCancelled )
+				continue;
+			// A merged read is cancelled in the kernel only once all of its transfers are cancelled.
+			Request * pLeader = pReq->pLeader;
+			bool bAllCancelled = true;
+			for ( Request * pMerged = pLeader->pFirstMerged; pMerged; pMerged = pMerged->pNextMerged )
+				bAllCancelled = bAllCancelled && pMerged->bCancelled;
+			if ( !bAllCancelled )
+				continue;
+			struct io_uring_sqe * pSqe = GetSqe();
+			pSqe->opcode = IORING_OP_ASYNC_CANCEL;
+			pSqe->fd = -1;
+			pSqe->addr = GetUserData( *pLeader );
+			pSqe->user_data = kCancelTag;
+			CommitSqe();
+		}
+
+		while ( !m_pending.IsEmpty() )
+		{
+			Request * pReq = m_pending.Pop();
+			if ( pReq->bCancelled )
+			{
+				pReq->pNextItem = pCancelled;
+				pCancelled = pReq;
+				continue;
+			}
+			pReq->pLeader = pReq;
+			pReq->pNextMerged = NULL;
+			pReq->pFirstMerged = pReq;
+			pReq->uMergedOffset = 0;
+			pReq->aMergedIov[0] = pReq->iov;
+			pReq->uNumMergedIov = 1;
+			MergeReads( pReq );
+
+			struct io_uring_sqe * pSqe = GetSqe();
+			pSqe->opcode = IORING_OP_READV;
+			pSqe->fd = pReq->iFd;
+			pSqe->ioprio = GetIoPrio( pReq->priority );
+			pSqe->off = pReq->pFirstMerged->uPosition;
+			pSqe->addr = (AkUInt64)(AkUIntPtr)pReq->aMergedIov;
+			pSqe->len = pReq->uNumMergedIov;
+			pSqe->user_data = GetUserData( *pReq );
+			CommitSqe();
+			for ( Request * pMerged = pReq->pFirstMerged; pMerged; pMerged = pMerged->pNextMerged )
+				pMerged->bInFlight = true;
+			AKPLATFORM::AkAtomicFetchAdd32( &m_iNumInFlight, 1, AkMemoryOrder_Relaxed );
+		}
+		return pCancelled;
+	}
+
+	/// Moves pending reads of the same file that are adjacent to in_pLeader's (or to those already merged with it) into its read,
+	/// then lays out the buffers of the merged read. Pending reads are few (at most AkDeviceSettings::uMaxConcurrentIO), so they are simply scanned.
+	void MergeReads( Request * in_pLeader )
+	{
+		Request * pLast = in_pLeader;
+		AkUInt64 uStart = in_pLeader->uPosition;
+		AkUInt64 uEnd = uStart + in_pLeader->iov.iov_len;
+		AkUInt32 uNumIov = 1;
+
+		bool bMerged = true;
+		while ( bMerged && uNumIov < AK_IOURING_MAX_MERGED_IOVECS )
+		{
+			bMerged = false;
+			for ( AkUInt32 i = 0; i < m_pending.Length(); i++ )
+			{
+				Request * pReq = m_pending[i].item;
+				if ( pReq->bCancelled || pReq->iFd != in_pLeader->iFd )
+					continue;
+
+				const AkUInt64 uReqEnd = pReq->uPosition + pReq->iov.iov_len;
+				if ( pReq->uPosition >= uEnd && pReq->uPosition - uEnd <= m_uMaxMergeGap )
+				{
+					const AkUInt32 uNeeded = ( pReq->uPosition > uEnd ) ? 2 : 1;
+					if ( uNumIov + uNeeded > AK_IOURING_MAX_MERGED_IOVECS )
+						continue;
+					pLast->pNextMerged = pReq;
+					pReq->pNextMerged = NULL;
+					pLast = pReq;
+					uEnd = uReqEnd;
+					uNumIov += uNeeded;
+				}
+				else if ( uReqEnd <= uStart && uStart - uReqEnd <= m_uMaxMergeGap )
+				{
+					const AkUInt32 uNeeded = ( uReqEnd < uStart ) ? 2 : 1;
+					if ( uNumIov + uNeeded > AK_IOURING_MAX_MERGED_IOVECS )
+						continue;
+					pReq->pNextMerged = in_pLeader->pFirstMerged;
+					in_pLeader->pFirstMerged = pReq;
+					uStart = pReq->uPosition;
+					uNumIov += uNeeded;
+				}
+				else
+					continue;
+
+				m_pending.Remove( pReq );
+				pReq->pLeader = in_pLeader;
+				bMerged = true;
+				break;
+			}
+		}
+
+		if ( in_pLeader->pFirstMerged == in_pLeader && !in_pLeader->pNextMerged )
+			return;
+
+		AkUInt32 uNumMergedIov = 0;
+		AkUInt64 uOffset = 0;
+		for ( Request * pReq = in_pLeader->pFirstMerged; pReq; pReq = pReq->pNextMerged )
+		{
+			const AkUInt64 uGap = pReq->uPosition - ( uStart + uOffset );
+			if ( uGap )
+			{
+				in_pLeader->aMergedIov[uNumMergedIov].iov_base = m_pGapBuffer;
+				in_pLeader->aMergedIov[uNumMergedIov].iov_len = (size_t)uGap;
+				++uNumMergedIov;
+				uOffset += uGap;
+				AKPLATFORM::AkAtomicFetchAdd64( &m_iNumGapBytes, (AkInt64)uGap, AkMemoryOrder_Relaxed );
+			}
+			pReq->uMergedOffset = (AkUInt32)uOffset;
+			in_pLeader->aMergedIov[uNumMergedIov++] = pReq->iov;
+			uOffset += pReq->iov.iov_len;
+			if ( pReq != in_pLeader )
+			{
+				AKPLATFORM::AkAtomicFetchAdd32( &m_iNumMergedTransfers, 1, AkMemoryOrder_Relaxed );
+				AKPLATFORM::AkAtomicFetchAdd64( &m_iNumMergedBytes, (AkInt64)pReq->iov.iov_len, AkMemoryOrder_Relaxed );
+			}
+		}
+		AKASSERT( uNumMergedIov == uNumIov );
+		in_pLeader->uNumMergedIov = uNumMergedIov;
+	}
+
+	/// Releases a request and calls its transfer back, outside of the lock.
+	void Complete( Request * in_pReq, AKRESULT in_eResult )
+	{
+		AkAsyncIOTransferInfo * pTransferInfo = in_pReq->pTransferInfo;
+		{
+			AkAutoLock<CAkLock> lock( m_lock );
+			in_pReq->pTransferInfo = NULL;
+			in_pReq->bInFlight = false;
+			in_pReq->pNextItem = m_pFree;
+			m_pFree = in_pReq;
+		}
+		// Before the callback, after which the Stream Manager may post the same transfer again.
+		if ( m_pTransferListener )
+			m_pTransferListener->OnTransferEnd( m_deviceID, pTransferInfo, in_eResult );
+		pTransferInfo->pCallback( pTransferInfo, in_eResult );
+	}
+
+	void ReapCompletions()
+	{
+		AkUInt32 uHead = *m_cq.pHead;
+		while ( uHead != __atomic_load_n( m_cq.pTail, __ATOMIC_ACQUIRE ) )
+		{
+			const struct io_uring_cqe * pCqe = &m_cq.pCqes[uHead & m_cq.uMask];
+			const AkUInt64 uUserData = pCqe->user_data;
+			const AkInt32 iRes = pCqe->res;
+			__atomic_store_n( m_cq.pHead, ++uHead, __ATOMIC_RELEASE );
+
+			if ( uUserData == kWakeupTag )
+			{
+				eventfd_t uValue;
+				AKVERIFY( read( m_iEventFd, &uValue, sizeof( uValue ) ) == sizeof( uValue ) );
+				m_bRearmWakeup = true;
+				continue;
+			}
+			if ( uUserData == kCancelTag )
+				continue;
+
+			Request * pLeader = &m_requests[(AkUInt32)uUserData - 1];
+			AKASSERT( pLeader->uGeneration == (AkUInt32)( uUserData >> 32 ) && pLeader->bInFlight );
+			AKPLATFORM::AkAtomicFetchAdd32( &m_iNumInFlight, -1, AkMemoryOrder_Relaxed );
+
+			// Fan the result of a merged read out to each of its transfers.
+			const AkReal64 fCompletionTime = GetTimeMs();
+			Request * pReq = pLeader->pFirstMerged;
+			while ( pReq )
+			{
+				Request * pNextMerged = pReq->pNextMerged;
+
+				bool bCancelled;
+				{
+					AkAutoLock<CAkLock> lock( m_lock );
+					bCancelled = pReq->bCancelled;
+				}
+
+				// Cancelled transfers must be resolved with AK_Success. Reads may end short at the end of the file.
+				AKRESULT eResult = AK_Success;
+				if ( !bCancelled )
+				{
+					if ( fCompletionTime > pReq->fDeadline )
+						AKPLATFORM::AkAtomicFetchAdd32( &m_iNumDeadlineMisses, 1, AkMemoryOrder_Relaxed );
+					const AkAsyncIOTransferInfo * pTransferInfo = pReq->pTransferInfo;
+					const AkInt64 iTransferred = ( iRes < 0 ) ? iRes : AkMax( (AkInt64)iRes - (AkInt64)pReq->uMergedOffset, (AkInt64)0 );
+					if ( iTransferred < 0 
+						|| ( iTransferred < (AkInt64)pTransferInfo->uRequestedSize 
+							&& (AkInt64)( pTransferInfo->uFilePosition - pReq->uFileOffset ) + iTransferred < pReq->iFileSize ) )
+					{
+						eResult = AK_Fail;
+					}
+				}
+				Complete( pReq, eResult );
+				pReq = pNextMerged;
+			}
+		}
+	}
+
+	void IoThreadLoop()
+	{
+		for ( ;; )
+		{
+			bool bStop;
+			Request * pCancelled = PrepareSubmissions( bStop );
+			while ( pCancelled )
+			{
+				Request * pReq = pCancelled;
+				pCancelled = pReq->pNextItem;
+				Complete( pReq, AK_Success );
+			}
+
+			if ( bStop && AKPLATFORM::AkAtomicLoad32( &m_iNumInFlight, AkMemoryOrder_Relaxed ) == 0 )
+				break;
+
+			// Submit the whole batch and wait for at least one completion, in a single system call.
+			const int iRet = (int)syscall( __NR_io_uring_enter, m_iRingFd, m_uNumToSubmit, 1, IORING_ENTER_GETEVENTS, NULL, 0 );
+			AKPLATFORM::AkAtomicFetchAdd32( &m_iNumSubmitCalls, 1, AkMemoryOrder_Relaxed );
+			if ( iRet >= 0 )
+				m_uNumToSubmit -= AkMin( (AkUInt32)iRet, m_uNumToSubmit );
+			else if ( errno != EINTR && errno != EAGAIN && errno != EBUSY )
+			{
+				AKASSERT( !"io_uring_enter failed" );
+				AKPLATFORM::AkSleep( 1 );
+			}
+
+			ReapCompletions();
+		}
+	}
+
+	static AK_DECLARE_THREAD_ROUTINE( IoThread )
+	{
+		CAkIoUringIOHook * pThis = AK_GET_THREAD_ROUTINE_PARAMETER_PTR( CAkIoUringIOHook );
+		pThis->IoThreadLoop();
+		AkExitThread( AK_RETURN_THREAD_OK );
+	}
+
+	struct SubmissionQueue
+	{
+		AkUInt32 *				pHead;
+		AkUInt32 *				pTail;
+		AkUInt32 *				pArray;
+		AkUInt32				uMask;
+		AkUInt32				uEntries;
+	};
+
+	struct CompletionQueue
+	{
+		AkUInt32 *				pHead;
+		AkUInt32 *				pTail;
+		struct io_uring_cqe *	pCqes;
+		AkUInt32				uMask;
+	};
+
+	typedef AkArray<Request, const Request &, ArrayPoolDefault> Requests;
+
+	CAkLock					m_lock;			// Protects request lists and states.
+	Requests				m_requests;
+	Request *				m_pFree;
+	AkDeadlineQueue<Request*>	m_pending;		// Earliest deadline first, then highest priority.
+	Request *				m_pCancelQueue;	// In-flight requests for which an IORING_OP_ASYNC_CANCEL must be submitted.
+
+	AkThread				m_hThread;
+	AkDeviceID				m_deviceID;
+	AkUInt32				m_uBlockSize;
+	AkUInt32				m_uMaxMergeGap;
+	void *					m_pGapBuffer;	// Receives the data between merged reads.
+	IAkIoUringTransferListener *	m_pTransferListener;
+
+	int						m_iRingFd;
+	int						m_iEventFd;
+	AkUInt8 *				m_pSqRing;
+	AkUInt8 *				m_pCqRing;
+	struct io_uring_sqe *	m_pSqes;
+	size_t					m_uSqRingSize;
+	size_t					m_uCqRingSize;
+	size_t					m_uSqesSize;
+	SubmissionQueue			m_sq;
+	CompletionQueue			m_cq;
+
+	AkAtomic32				m_iNumInFlight;	// Read by GetDeviceData() from other threads.
+	AkUInt32				m_uNumToSubmit;
+
+	// Statistics, read by the Get*() accessors from other threads. 64-bit counters are aligned so that they are atomic on 32-bit targets too.
+	AkAtomic32				m_iNumSubmitCalls;
+	AkAtomic32				m_iNumTransfers;
+	AkAtomic32				m_iNumCancelled;
+	AkAtomic32				m_iNumMergedTransfers;
+	AkAtomic64				m_iNumMergedBytes __attribute__((aligned(8)));
+	AkAtomic64				m_iNumGapBytes __attribute__((aligned(8)));
+	AkAtomic32				m_iNumDeadlineMisses;
+
+	bool					m_bDirectIO;
+	bool					m_bWakeupPending;	// An eventfd write is pending; further posts do not need to signal.
+	bool					m_bRearmWakeup;		// The eventfd poll completed and must be re-armed. Completion thread only.
+	bool					m_bStop;
+};
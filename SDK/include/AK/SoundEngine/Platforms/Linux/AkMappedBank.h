@@ -0,0 +1,163 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkMappedBank.h
+
+/// \file 
+/// Zero-copy loading of a SoundBank from a memory-mapped file.
+/// The .bnk file is mapped read-only and passed to the in-place in-memory AK::SoundEngine::LoadBank(), which keeps 
+/// the pointer rather than copying the bank: media is played from the mapping, with the page cache as backing store. 
+/// Processes that load the same bank share its pages, and pages of media that is not played are never read from disk.
+/// 
+/// Usage: 
+/// - Load() maps the file and loads the bank synchronously; Unload() unloads it, then unmaps the file.
+/// - To load asynchronously, Map() the file and pass GetData() and GetSize() to the in-place asynchronous LoadBank() overload; 
+/// Unmap() only after the bank is completely unloaded (UnloadBank() with GetData() as memory pointer).
+/// 
+/// \remarks 
+/// - Mappings are page-aligned, which satisfies AK_BANK_PLATFORM_DATA_ALIGNMENT.
+/// - As with all in-place banks, event and structure data is still parsed into the default pool.
+/// - Pages are not pinned: a voice may take a page fault the first time it reads media that was evicted from the page cache. 
+/// Pinning pages only while voices reference them would require support from the sound engine. Use Load( ..., true ) 
+/// to read the whole bank when it is loaded instead.
+
+#pragma once
+
+#include <AK/SoundEngine/Common/AkSoundEngine.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/// SoundBank loaded in place from a memory-mapped file.
+class CAkMappedBank
+{
+public:
+	CAkMappedBank()
+		: m_pData( NULL )
+		, m_uSize( 0 )
+		, m_bankID( AK_INVALID_BANK_ID )
+	{}
+
+	~CAkMappedBank()
+	{
+		AKASSERT( !m_pData || !"Unload() or Unmap() was not called" );
+	}
+
+	/// Maps a bank file read-only.
+	/// \return AK_Success, AK_FileNotFound, or AK_Fail if the file is empty, too big or cannot be mapped.
+	AKRESULT Map(
+		const char * in_pszFilePath,		///< Path of the .bnk file
+		bool in_bPrefault = false			///< Read the whole file now, so that voices take no page fault when they first play its media
+		)
+	{
+		AKASSERT( !m_pData );
+		const int iFd = open( in_pszFilePath, O_RDONLY | O_CLOEXEC );
+		if ( iFd < 0 )
+			return AK_FileNotFound;
+
+		struct stat fileStat;
+		if ( fstat( iFd, &fileStat ) != 0 || fileStat.st_size <= 0 || (AkUInt64)fileStat.st_size > (AkUInt64)0xFFFFFFFF )
+		{
+			close( iFd );
+			return AK_Fail;
+		}
+
+		const size_t uSize = (size_t)fileStat.st_size;
+		void * pData = mmap( NULL, uSize, PROT_READ, MAP_SHARED | ( in_bPrefault ? MAP_POPULATE : 0 ), iFd, 0 );
+		close( iFd );
+		if ( pData == MAP_FAILED )
+			return AK_Fail;
+
+		m_pData = pData;
+		m_uSize = (AkUInt32)uSize;
+		return AK_Success;
+	}
+
+	/// Unmaps the file. The bank must not be loaded.
+	void Unmap()
+	{
+		AKASSERT( m_bankID == AK_INVALID_BANK_ID || !"Unload() the bank first" );
+		if ( m_pData )
+			munmap( m_pData, m_uSize );
+		m_pData = NULL;
+		m_uSize = 0;
+	}
+
+	/// Maps a bank file and loads it synchronously, in place.
+	/// \return AK_Success, AK_FileNotFound, or the error returned by AK::SoundEngine::LoadBank().
+	AKRESULT Load(
+		const char * in_pszFilePath,		///< Path of the .bnk file
+		bool in_bPrefault = false			///< Read the whole file now, so that voices take no page fault when they first play its media
+		)
+	{
+		AKRESULT eResult = Map( in_pszFilePath, in_bPrefault );
+		if ( eResult != AK_Success )
+			return eResult;
+
+		AkBankID bankID;
+		eResult = AK::SoundEngine::LoadBank( m_pData, m_uSize, bankID );
+		if ( eResult != AK_Success )
+		{
+			Unmap();
+			return eResult;
+		}
+		m_bankID = bankID;
+		return AK_Success;
+	}
+
+	/// Unloads the bank synchronously, then unmaps the file.
+	/// \return The result of AK::SoundEngine::UnloadBank(). The file stays mapped if it failed.
+	AKRESULT Unload()
+	{
+		if ( m_bankID != AK_INVALID_BANK_ID )
+		{
+			const AKRESULT eResult = AK::SoundEngine::UnloadBank( m_bankID, m_pData );
+			if ( eResult != AK_Success )
+				return eResult;
+			m_bankID = AK_INVALID_BANK_ID;
+		}
+		Unmap();
+		return AK_Success;
+	}
+
+	/// ID of the bank loaded by Load(), or AK_INVALID_BANK_ID.
+	inline AkBankID GetBankID() const { return m_bankID; }
+
+	/// Address of the mapping, to pass to LoadBank() and UnloadBank(). NULL if the file is not mapped.
+	inline const void * GetData() const { return m_pData; }
+
+	/// Size of the mapped bank, in bytes.
+	inline AkUInt32 GetSize() const { return m_uSize; }
+
+private:
+	void *		m_pData;
+	AkUInt32	m_uSize;
+	AkBankID	m_bankID;
+};
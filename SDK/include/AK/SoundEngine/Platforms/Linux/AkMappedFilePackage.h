@@ -0,0 +1,440 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkMappedFilePackage.h
+
+/// \file 
+/// File package whose lookup table is memory-mapped and indexed by a minimal perfect hash of the file ID, language and type.
+/// Opening a file costs one bucket seed read, two hashes and one entry comparison; the table is never copied to the heap.
+/// 
+/// Layout, in the byte order of the target platform:
+/// - AkMappedPackageHeader
+/// - Bucket seeds (AkUInt32 x AkMappedPackageHeader::uNumBuckets), padded to 8 bytes
+/// - AkMappedPackageEntry x AkMappedPackageHeader::uNumFiles, in hash slot order
+/// - File data, each file aligned to AkMappedPackageHeader::uBlockSize
+/// 
+/// Usage: 
+/// - Build packages with CAkMappedFilePackageWriter (e.g. in a packaging tool).
+/// - Open the package with your Low-Level I/O hook (e.g. CAkIoUringIOHook::Open()), then pass the returned descriptor to CAkMappedFilePackage::Load().
+/// - Register the CAkMappedFilePackage as the File Location Resolver (AK::StreamMgr::SetFileLocationResolver()). 
+/// All files of the package share the package's handle: the hook's Close() must ignore descriptors for which AkIsMappedPackageMember() is true
+/// (CAkIoUringIOHook::Close() ignores all descriptors with a non-NULL AkFileDesc::pCustomParam).
+
+#pragma once
+
+#include <AK/SoundEngine/Common/AkStreamMgrModule.h>
+#include <AK/Tools/Common/AkFNVHash.h>
+#include <AK/Tools/Common/AkMinimalPerfectHash.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#define AK_MAPPED_PACKAGE_MAGIC			(0x504D4B41)	///< "AKMP"
+#define AK_MAPPED_PACKAGE_VERSION		(1)
+#define AK_MAPPED_PACKAGE_NO_LANGUAGE	(0)				///< Language ID of files that are not language-specific.
+#define AK_MAPPED_PACKAGE_ENTRY_BANK	(0x1)			///< AkMappedPackageEntry::uFlags: sound bank (opened by name, or by ID with AKCODECID_BANK). Banks and streamed files have separate ID spaces.
+
+struct AkMappedPackageHeader
+{
+	AkUInt32	uMagic;			///< AK_MAPPED_PACKAGE_MAGIC
+	AkUInt32	uVersion;		///< AK_MAPPED_PACKAGE_VERSION
+	AkUInt32	uNumFiles;		///< Number of entries
+	AkUInt32	uNumBuckets;	///< Number of bucket seeds, AK::MPH::GetNumBuckets( uNumFiles )
+	AkUInt32	uBlockSize;		///< Alignment of file data, in bytes
+	AkUInt32	uReserved;
+	AkUInt64	uIndexSize;		///< Size of the header, seeds and entries, rounded up to uBlockSize: offset of the first file
+};
+
+struct AkMappedPackageEntry
+{
+	AkFileID	fileID;			///< File ID, or AK::SoundEngine::GetIDFromString() of the file name
+	AkUInt32	languageID;		///< Hash of the language name (see CAkMappedFilePackage::GetLanguageID()), or AK_MAPPED_PACKAGE_NO_LANGUAGE
+	AkUInt32	uFlags;			///< AK_MAPPED_PACKAGE_ENTRY_BANK or 0
+	AkUInt32	uReserved;
+	AkUInt64	uOffset;		///< Offset of the file data in the package, multiple of AkMappedPackageHeader::uBlockSize
+	AkUInt64	uSize;			///< Size of the file, in bytes
+};
+
+/// Key hashed by the package index.
+inline AkUInt64 AkMappedPackageKey( AkFileID in_fileID, AkUInt32 in_languageID, AkUInt32 in_uFlags )
+{
+	return ( (AkUInt64)( in_languageID ^ ( in_uFlags << 31 ) ) << 32 ) | in_fileID;
+}
+
+/// Unique address stored in AkFileDesc::pCustomParam of the files opened from a CAkMappedFilePackage.
+inline void * AkMappedPackageMemberTag()
+{
+	static char s_tag;
+	return &s_tag;
+}
+
+/// True if the descriptor was returned by CAkMappedFilePackage::Open(): its handle belongs to the package and must not be closed.
+inline bool AkIsMappedPackageMember( const AkFileDesc & in_fileDesc )
+{
+	return in_fileDesc.pCustomParam == AkMappedPackageMemberTag();
+}
+
+/// File Location Resolver for a memory-mapped package.
+/// Files are opened synchronously, without allocation nor system call.
+class CAkMappedFilePackage : public AK::StreamMgr::IAkFileLocationResolver
+{
+public:
+	CAkMappedFilePackage()
+		: m_pMapping( NULL )
+		, m_uMappingSize( 0 )
+		, m_pHeader( NULL )
+		, m_pSeeds( NULL )
+		, m_pEntries( NULL )
+		, m_uBlockSize( 1 )
+		, m_languageID( AK_MAPPED_PACKAGE_NO_LANGUAGE )
+	{
+		AKPLATFORM::AkMemSet( &m_packageDesc, 0, sizeof( m_packageDesc ) );
+	}
+
+	virtual ~CAkMappedFilePackage()
+	{
+		AKASSERT( !m_pMapping || !"Unload() was not called" );
+	}
+
+	/// Maps the header and index of a package.
+	/// \return AK_Success, AK_FileNotFound, or AK_Fail if the file is not a valid package.
+	AKRESULT Load(
+		const char * in_pszFilePath,			///< Path of the package
+		const AkFileDesc & in_packageDesc,		///< Descriptor of the package, opened by the Low-Level I/O hook. Its handle must outlive this object.
+		AkUInt32 in_uHookBlockSize,				///< Block size of the package file (AK::StreamMgr::IAkLowLevelIOHook::GetBlockSize())
+		bool in_bPrefault = true				///< Read the whole index when loading, so that no page fault occurs when opening files
+		)
+	{
+		AKASSERT( !m_pMapping );
+		const int iFd = open( in_pszFilePath, O_RDONLY | O_CLOEXEC );
+		if ( iFd < 0 )
+			return AK_FileNotFound;
+
+		AkMappedPackageHeader header;
+		struct stat fileStat;
+		if ( fstat( iFd, &fileStat ) != 0 
+			|| pread( iFd, &header, sizeof( header ), 0 ) != (ssize_t)sizeof( header ) 
+			|| header.uMagic != AK_MAPPED_PACKAGE_MAGIC 
+			|| header.uVersion != AK_MAPPED_PACKAGE_VERSION 
+			|| header.uNumBuckets != AK::MPH::GetNumBuckets( header.uNumFiles ) 
+			|| header.uBlockSize == 0 
+			|| header.uBlockSize % in_uHookBlockSize != 0 
+			|| header.uIndexSize < GetIndexSize( header.uNumFiles, header.uNumBuckets ) 
+			|| header.uIndexSize > (AkUInt64)fileStat.st_size )
+		{
+			close( iFd );
+			return AK_Fail;
+		}
+
+		const size_t uMappingSize = (size_t)GetIndexSize( header.uNumFiles, header.uNumBuckets );
+		void * pMapping = mmap( NULL, uMappingSize, PROT_READ, MAP_SHARED | ( in_bPrefault ? MAP_POPULATE : 0 ), iFd, 0 );
+		close( iFd );
+		if ( pMapping == MAP_FAILED )
+			return AK_Fail;
+
+		m_pMapping = pMapping;
+		m_uMappingSize = uMappingSize;
+		m_pHeader = (const AkMappedPackageHeader*)pMapping;
+		m_pSeeds = (const AkUInt32*)( m_pHeader + 1 );
+		m_pEntries = (const AkMappedPackageEntry*)( (const AkUInt8*)pMapping + GetEntriesOffset( header.uNumBuckets ) );
+		m_packageDesc = in_packageDesc;
+		m_uBlockSize = in_uHookBlockSize;
+		return AK_Success;
+	}
+
+	/// Unmaps the index. Files opened from the package must be closed.
+	void Unload()
+	{
+		if ( m_pMapping )
+			munmap( m_pMapping, m_uMappingSize );
+		m_pMapping = NULL;
+		m_uMappingSize = 0;
+		m_pHeader = NULL;
+		m_pSeeds = NULL;
+		m_pEntries = NULL;
+	}
+
+	/// Selects the language of language-specific files.
+	inline void SetLanguage( AkUInt32 in_languageID ) { m_languageID = in_languageID; }
+
+	/// ID of a language name, as stored in AkMappedPackageEntry::languageID. Case-insensitive.
+	static inline AkUInt32 GetLanguageID( const char * in_pszLanguage ) { return HashName( in_pszLanguage ); }
+
+	/// ID of a file name, as used by Open(): FNV-1 32-bit hash of the lower-case name (same as AK::SoundEngine::GetIDFromString()).
+	static AkUInt32 HashName( const char * in_pszName )
+	{
+		AK::FNVHash32 hash;
+		for ( const char * pChar = in_pszName; *pChar; ++pChar )
+		{
+			const char cLower = ( *pChar >= 'A' && *pChar <= 'Z' ) ? ( *pChar - 'A' + 'a' ) : *pChar;
+			hash.Compute( &cLower, 1 );
+		}
+		return hash.Get();
+	}
+
+	/// Finds a file in the package.
+	/// \return The entry, or NULL if the package has no such file.
+	const AkMappedPackageEntry * Find( AkFileID in_fileID, AkUInt32 in_languageID, AkUInt32 in_uFlags ) const
+	{
+		if ( !m_pHeader || m_pHeader->uNumFiles == 0 )
+			return NULL;
+		const AkUInt64 uKey = AkMappedPackageKey( in_fileID, in_languageID, in_uFlags );
+		const AkMappedPackageEntry * pEntry = &m_pEntries[ AK::MPH::Lookup( uKey, m_pSeeds, m_pHeader->uNumBuckets, m_pHeader->uNumFiles ) ];
+		if ( pEntry->fileID != in_fileID || pEntry->languageID != in_languageID || pEntry->uFlags != in_uFlags )
+			return NULL;
+		return pEntry;
+	}
+
+	inline AkUInt32 GetNumFiles() const { return m_pHeader ? m_pHeader->uNumFiles : 0; }
+
+	// IAkFileLocationResolver
+
+	/// Files opened by name are sound banks.
+	virtual AKRESULT Open( 
+		const AkOSChar*			in_pszFileName,
+		AkOpenMode				in_eOpenMode,
+		AkFileSystemFlags *		in_pFlags,
+		bool &					io_bSyncOpen,
+		AkFileDesc &			io_fileDesc
+		)
+	{
+		return OpenEntry( HashName( in_pszFileName ), AK_MAPPED_PACKAGE_ENTRY_BANK, in_eOpenMode, in_pFlags, io_bSyncOpen, io_fileDesc );
+	}
+
+	virtual AKRESULT Open( 
+		AkFileID				in_fileID,
+		AkOpenMode				in_eOpenMode,
+		AkFileSystemFlags *		in_pFlags,
+		bool &					io_bSyncOpen,
+		AkFileDesc &			io_fileDesc
+		)
+	{
+		const AkUInt32 uFlags = ( in_pFlags && in_pFlags->uCodecID == AKCODECID_BANK ) ? AK_MAPPED_PACKAGE_ENTRY_BANK : 0;
+		return OpenEntry( in_fileID, uFlags, in_eOpenMode, in_pFlags, io_bSyncOpen, io_fileDesc );
+	}
+
+	/// Size of the header, seeds and entries of a package.
+	static inline AkUInt64 GetIndexSize( AkUInt32 in_uNumFiles, AkUInt32 in_uNumBuckets )
+	{
+		return GetEntriesOffset( in_uNumBuckets ) + (AkUInt64)in_uNumFiles * sizeof( AkMappedPackageEntry );
+	}
+
+	static inline AkUInt64 GetEntriesOffset( AkUInt32 in_uNumBuckets )
+	{
+		return ( sizeof( AkMappedPackageHeader ) + (AkUInt64)in_uNumBuckets * sizeof( AkUInt32 ) + 7 ) & ~(AkUInt64)7;
+	}
+
+private:
+	AKRESULT OpenEntry( 
+		AkFileID				in_fileID,
+		AkUInt32				in_uFlags,
+		AkOpenMode				in_eOpenMode,
+		AkFileSystemFlags *		in_pFlags,
+		bool &					io_bSyncOpen,
+		AkFileDesc &			io_fileDesc
+		)
+	{
+		if ( in_eOpenMode != AK_OpenModeRead )
+			return AK_Fail;
+
+		const AkUInt32 languageID = ( in_pFlags && in_pFlags->bIsLanguageSpecific ) ? m_languageID : AK_MAPPED_PACKAGE_NO_LANGUAGE;
+		const AkMappedPackageEntry * pEntry = Find( in_fileID, languageID, in_uFlags );
+		if ( !pEntry )
+			return AK_FileNotFound;
+
+		io_bSyncOpen = true;
+		io_fileDesc = m_packageDesc;
+		io_fileDesc.iFileSize = (AkInt64)pEntry->uSize;
+		io_fileDesc.uSector = (AkUInt32)( pEntry->uOffset / m_uBlockSize );
+		// uCustomParamSize is inherited from the package: it may hold flags of the Low-Level I/O hook (e.g. AK_IOURING_FILE_DIRECT_IO).
+		io_fileDesc.pCustomParam = AkMappedPackageMemberTag();
+		return AK_Success;
+	}
+
+	void *							m_pMapping;
+	size_t							m_uMappingSize;
+	const AkMappedPackageHeader *	m_pHeader;
+	const AkUInt32 *				m_pSeeds;
+	const AkMappedPackageEntry *	m_pEntries;
+	AkFileDesc						m_packageDesc;
+	AkUInt32						m_uBlockSize;	// Block size of the Low-Level I/O hook, unit of AkFileDesc::uSector.
+	AkUInt32						m_languageID;
+};
+
+/// Builds a package from a list of files. TAlloc provides the memory of the file list and of the index; 
+/// a stand-alone packaging tool may use an allocator based on malloc().
+template <class TAlloc = ArrayPoolDefault>
+class CAkMappedFilePackageWriter
+{
+public:
+	~CAkMappedFilePackageWriter()
+	{
+		m_files.Term();
+	}
+
+	/// Adds a file to the package.
+	/// \return AK_Success or AK_InsufficientMemory.
+	AKRESULT AddFile( 
+		AkFileID in_fileID,						///< File ID. For sound banks opened by name, CAkMappedFilePackage::HashName() of the name.
+		AkUInt32 in_languageID,					///< CAkMappedFilePackage::GetLanguageID() of the language, or AK_MAPPED_PACKAGE_NO_LANGUAGE
+		bool in_bIsBank,						///< True for sound banks
+		const char * in_pszSourcePath			///< Path of the file to copy into the package. Must remain valid until Write() returns.
+		)
+	{
+		SourceFile * pFile = m_files.AddLast();
+		if ( !pFile )
+			return AK_InsufficientMemory;
+		pFile->entry.fileID = in_fileID;
+		pFile->entry.languageID = in_languageID;
+		pFile->entry.uFlags = in_bIsBank ? AK_MAPPED_PACKAGE_ENTRY_BANK : 0;
+		pFile->entry.uReserved = 0;
+		pFile->entry.uOffset = 0;
+		pFile->entry.uSize = 0;
+		pFile->pszSourcePath = in_pszSourcePath;
+		return AK_Success;
+	}
+
+	/// Builds the index and writes the package.
+	/// \return AK_Success, AK_FileNotFound if a source file could not be read, AK_InsufficientMemory, 
+	/// or AK_Fail if no file was added, the same file was added twice or the package could not be written.
+	AKRESULT Write( 
+		const char * in_pszPackagePath,			///< Path of the package
+		AkUInt32 in_uBlockSize = 4096			///< Alignment of file data; a multiple of the block size of the device and of the Low-Level I/O hook (e.g. O_DIRECT)
+		)
+	{
+		AKASSERT( in_uBlockSize > 0 );
+		const AkUInt32 uNumFiles = m_files.Length();
+		if ( uNumFiles == 0 )
+			return AK_Fail;
+		AkMappedPackageHeader header;
+		header.uMagic = AK_MAPPED_PACKAGE_MAGIC;
+		header.uVersion = AK_MAPPED_PACKAGE_VERSION;
+		header.uNumFiles = uNumFiles;
+		header.uNumBuckets = AK::MPH::GetNumBuckets( uNumFiles );
+		header.uBlockSize = in_uBlockSize;
+		header.uReserved = 0;
+		header.uIndexSize = AlignUp( CAkMappedFilePackage::GetIndexSize( uNumFiles, header.uNumBuckets ), in_uBlockSize );
+
+		AkArray<AkUInt64, AkUInt64, TAlloc> keys;
+		AkArray<AkUInt32, AkUInt32, TAlloc> seeds;
+		AkArray<AkUInt32, AkUInt32, TAlloc> slots;
+		AkArray<AkMappedPackageEntry, const AkMappedPackageEntry &, TAlloc> entries;
+		AKRESULT eResult = AK_InsufficientMemory;
+		if ( keys.Resize( uNumFiles ) && seeds.Resize( header.uNumBuckets ) && slots.Resize( uNumFiles ) && entries.Resize( uNumFiles ) )
+		{
+			for ( AkUInt32 i = 0; i < uNumFiles; i++ )
+			{
+				const AkMappedPackageEntry & entry = m_files[i].entry;
+				keys[i] = AkMappedPackageKey( entry.fileID, entry.languageID, entry.uFlags );
+			}
+			eResult = AK::MPH::Build<TAlloc>( &keys[0], uNumFiles, &seeds[0], &slots[0] );
+			if ( eResult == AK_Success )
+				eResult = WritePackage( in_pszPackagePath, header, seeds, slots, entries );
+		}
+		keys.Term();
+		seeds.Term();
+		slots.Term();
+		entries.Term();
+		return eResult;
+	}
+
+private:
+	struct SourceFile
+	{
+		AkMappedPackageEntry	entry;
+		const char *			pszSourcePath;
+	};
+
+	static inline AkUInt64 AlignUp( AkUInt64 in_uValue, AkUInt32 in_uAlignment )
+	{
+		return ( in_uValue + in_uAlignment - 1 ) / in_uAlignment * in_uAlignment;
+	}
+
+	template <class TSeeds, class TSlots, class TEntries>
+	AKRESULT WritePackage( const char * in_pszPackagePath, const AkMappedPackageHeader & in_header, const TSeeds & in_seeds, const TSlots & in_slots, TEntries & io_entries )
+	{
+		FILE * pPackage = fopen( in_pszPackagePath, "wb" );
+		if ( !pPackage )
+			return AK_Fail;
+
+		// File data first, then the index, which holds the offsets.
+		AKRESULT eResult = AK_Success;
+		AkUInt64 uOffset = in_header.uIndexSize;
+		char buffer[ 64 * 1024 ];
+		for ( AkUInt32 i = 0; i < m_files.Length() && eResult == AK_Success; i++ )
+		{
+			AkMappedPackageEntry & entry = io_entries[ in_slots[i] ];
+			entry = m_files[i].entry;
+			entry.uOffset = uOffset;
+
+			FILE * pSource = fopen( m_files[i].pszSourcePath, "rb" );
+			if ( !pSource || fseeko( pPackage, (off_t)uOffset, SEEK_SET ) != 0 )
+			{
+				eResult = pSource ? AK_Fail : AK_FileNotFound;
+				if ( pSource )
+					fclose( pSource );
+				break;
+			}
+			size_t uRead;
+			while ( ( uRead = fread( buffer, 1, sizeof( buffer ), pSource ) ) > 0 )
+			{
+				if ( fwrite( buffer, 1, uRead, pPackage ) != uRead )
+				{
+					eResult = AK_Fail;
+					break;
+				}
+				entry.uSize += uRead;
+			}
+			fclose( pSource );
+			uOffset = AlignUp( uOffset + entry.uSize, in_header.uBlockSize );
+		}
+
+		static const AkUInt8 padding[8] = { 0 };
+		const size_t uSeedsPadding = (size_t)( CAkMappedFilePackage::GetEntriesOffset( in_header.uNumBuckets ) - sizeof( in_header ) - in_header.uNumBuckets * sizeof( AkUInt32 ) );
+		if ( eResult == AK_Success 
+			&& ( fseeko( pPackage, 0, SEEK_SET ) != 0 
+				|| fwrite( &in_header, sizeof( in_header ), 1, pPackage ) != 1 
+				|| fwrite( &in_seeds[0], sizeof( AkUInt32 ), in_header.uNumBuckets, pPackage ) != in_header.uNumBuckets 
+				|| fwrite( padding, 1, uSeedsPadding, pPackage ) != uSeedsPadding 
+				|| fwrite( &io_entries[0], sizeof( AkMappedPackageEntry ), m_files.Length(), pPackage ) != m_files.Length() 
+				|| fflush( pPackage ) != 0 
+				|| ftruncate( fileno( pPackage ), (off_t)uOffset ) != 0 ) )	// Pad the last file to a whole block.
+		{
+			eResult = AK_Fail;
+		}
+
+		if ( fclose( pPackage ) != 0 && eResult == AK_Success )
+			eResult = AK_Fail;
+		return eResult;
+	}
+
+	AkArray<SourceFile, const SourceFile &, TAlloc, AkGrowByGeometric> m_files;
+};
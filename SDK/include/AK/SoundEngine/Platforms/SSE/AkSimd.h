@@ -441,5 +441,6 @@ typedef __m64	AKSIMD_V2F32;	///< Vector of 2 32-bit floats
 
 #endif
 
+#include <AK/SoundEngine/Platforms/SSE/AkSimdAvx.h>
 
 #endif //_AK_SIMD_SSE_H_
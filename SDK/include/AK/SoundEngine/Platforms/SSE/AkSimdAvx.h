@@ -0,0 +1,195 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkSimdAvx.h
+
+/// \file 
+/// AKSIMD - AVX implementation of the 8-wide vector type.
+/// The AVX code is compiled per function (see AKSIMD_V8F32_FUNC), so that it can be built
+/// without enabling AVX for a whole module, and selected at runtime with AKSIMD_V8F32_ENABLED().
+
+#ifndef _AK_SIMD_AVX_H_
+#define _AK_SIMD_AVX_H_
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+
+#if ( defined( AK_CPU_X86 ) || defined( AK_CPU_X86_64 ) ) && !defined( AK_IOS ) && ( defined( _MSC_VER ) || defined( __GNUC__ ) || defined( __clang__ ) )
+
+#include <immintrin.h>
+#if defined( _MSC_VER ) && !defined( __clang__ )
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#define AKSIMD_V8F32_SUPPORTED
+
+////////////////////////////////////////////////////////////////////////
+/// @name AKSIMD V8F32 function attributes
+//@{
+
+#if defined( _MSC_VER ) && !defined( __clang__ )
+/// Declaration attribute for functions using AKSIMD_V8F32 instructions. Such functions must only be called when AKSIMD_V8F32_ENABLED() is true.
+#define AKSIMD_V8F32_FUNC
+#else
+/// Declaration attribute for functions using AKSIMD_V8F32 instructions. Such functions must only be called when AKSIMD_V8F32_ENABLED() is true.
+#define AKSIMD_V8F32_FUNC __attribute__((target("avx")))
+#endif
+
+//@}
+////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////
+/// @name AKSIMD V8F32 types
+//@{
+
+typedef __m256	AKSIMD_V8F32;	///< Vector of 8 32-bit floats
+
+//@}
+////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////
+/// @name AKSIMD V8F32 loading / setting / storing
+//@{
+
+/// Loads eight single-precision, floating-point values. The address
+/// must be 32-byte aligned (see _mm256_load_ps)
+#define AKSIMD_LOAD_V8F32( __addr__ ) _mm256_load_ps( (AkReal32*)(__addr__) )
+
+/// Loads eight single-precision floating-point values from unaligned
+/// memory (see _mm256_loadu_ps)
+#define AKSIMD_LOADU_V8F32( __addr__ ) _mm256_loadu_ps( (AkReal32*)(__addr__) )
+
+/// Loads a single single-precision, floating-point value, copying it into
+/// all eight words (see _mm256_broadcast_ss)
+#define AKSIMD_LOAD1_V8F32( __scalar__ ) _mm256_broadcast_ss( &(__scalar__) )
+
+/// Sets the eight single-precision, floating-point values to in_value (see _mm256_set1_ps)
+#define AKSIMD_SET_V8F32( __scalar__ ) _mm256_set1_ps( (__scalar__) )
+
+/// Sets the eight single-precision, floating-point values to zero (see _mm256_setzero_ps)
+#define AKSIMD_SETZERO_V8F32() _mm256_setzero_ps()
+
+/// Stores eight single-precision, floating-point values. The address
+/// must be 32-byte aligned (see _mm256_store_ps)
+#define AKSIMD_STORE_V8F32( __addr__, __vec__ ) _mm256_store_ps( (AkReal32*)(__addr__), (__vec__) )
+
+/// Stores eight single-precision, floating-point values. The address
+/// does not need to be 32-byte aligned (see _mm256_storeu_ps).
+#define AKSIMD_STOREU_V8F32( __addr__, __vec__ ) _mm256_storeu_ps( (AkReal32*)(__addr__), (__vec__) )
+
+//@}
+////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////
+/// @name AKSIMD V8F32 arithmetic
+//@{
+
+/// Adds the eight single-precision, floating-point values of a and b (see _mm256_add_ps)
+#define AKSIMD_ADD_V8F32( a, b ) _mm256_add_ps( a, b )
+
+/// Subtracts the eight single-precision, floating-point values of a and b (a - b) (see _mm256_sub_ps)
+#define AKSIMD_SUB_V8F32( a, b ) _mm256_sub_ps( a, b )
+
+/// Multiplies the eight single-precision, floating-point values of a and b (see _mm256_mul_ps)
+#define AKSIMD_MUL_V8F32( a, b ) _mm256_mul_ps( a, b )
+
+/// Vector multiply-add operation.
+#define AKSIMD_MADD_V8F32( __a__, __b__, __c__ ) _mm256_add_ps( _mm256_mul_ps( (__a__), (__b__) ), (__c__) )
+
+/// Computes the minima of the eight single-precision, floating-point values of a and b (see _mm256_min_ps)
+#define AKSIMD_MIN_V8F32( a, b ) _mm256_min_ps( a, b )
+
+/// Computes the maximums of the eight single-precision, floating-point values of a and b (see _mm256_max_ps)
+#define AKSIMD_MAX_V8F32( a, b ) _mm256_max_ps( a, b )
+
+//@}
+////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////
+/// @name AKSIMD V8F32 runtime dispatch
+//@{
+
+namespace AK
+{
+	namespace SIMD
+	{
+		/// Storage of the V8F32 dispatch flag, shared by all translation units of a module. Use AKSIMD_V8F32_ENABLED() to read it.
+		inline bool & V8F32Enabled()
+		{
+			static bool s_bEnabled = false;
+			return s_bEnabled;
+		}
+
+		/// Returns true if the processor supports AVX and the OS saves the upper halves of the YMM registers on context switch.
+		/// The IAkProcessorFeatures interface of the sound engine does not report AVX, so it is detected here with cpuid and xgetbv.
+		inline bool IsAvxSupported()
+		{
+#if defined( _MSC_VER ) && !defined( __clang__ )
+			int cpuInfo[4];
+			__cpuid( cpuInfo, 1 );
+			const AkUInt32 uEcx = (AkUInt32)cpuInfo[2];
+#else
+			unsigned int uEax, uEbx, uEcx, uEdx;
+			if ( !__get_cpuid( 1, &uEax, &uEbx, &uEcx, &uEdx ) )
+				return false;
+#endif
+			// OSXSAVE (bit 27) is required before xgetbv may be executed; AVX is bit 28.
+			if ( ( uEcx & ( ( 1U << 27 ) | ( 1U << 28 ) ) ) != ( ( 1U << 27 ) | ( 1U << 28 ) ) )
+				return false;
+
+#if defined( _MSC_VER ) && !defined( __clang__ )
+			const AkUInt64 uXcr0 = _xgetbv( 0 );
+#else
+			AkUInt32 uXcr0Lo, uXcr0Hi;
+			__asm__ __volatile__ ( "xgetbv" : "=a"( uXcr0Lo ), "=d"( uXcr0Hi ) : "c"( 0 ) );
+			const AkUInt64 uXcr0 = ( (AkUInt64)uXcr0Hi << 32 ) | uXcr0Lo;
+#endif
+			// XMM (bit 1) and YMM (bit 2) state must both be enabled by the OS.
+			return ( uXcr0 & 0x6 ) == 0x6;
+		}
+
+		/// Selects the AKSIMD_V8F32 code paths of the helpers in this SDK (AK::DSP::ApplyGain, AK::SpeakerVolumes::Matrix, ...) 
+		/// if the processor and OS support AVX. Each module (plug-in library, game executable) must call it once, typically from 
+		/// the plug-in's Init(). Until then, the AKSIMD_V4F32 paths are used.
+		inline void InitDispatch()
+		{
+			V8F32Enabled() = IsAvxSupported();
+		}
+	}
+}
+
+/// True when AKSIMD_V8F32_FUNC functions may be called. \sa AK::SIMD::InitDispatch()
+#define AKSIMD_V8F32_ENABLED() ( AK::SIMD::V8F32Enabled() )
+
+//@}
+////////////////////////////////////////////////////////////////////////
+
+#endif
+
+#endif //_AK_SIMD_AVX_H_
@@ -0,0 +1,548 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkAllocSampler.h
+
+/// \file 
+/// Sampling allocation profiler, for applications that provide their own implementation of the AK::MemoryMgr functions 
+/// instead of linking the default Memory Manager. Those functions see every allocation of the sound engine and its plug-ins, with its pool: 
+/// call ShouldSample() and RecordAlloc() from AK::MemoryMgr::Malloc() and AK::MemoryMgr::Malign() (and their debug versions), 
+/// and RecordFree() from AK::MemoryMgr::Free() and AK::MemoryMgr::Falign().
+/// AK::AllocHook() and AK::FreeHook() cannot be used: they only allocate the memory blocks of whole AkMalloc pools, without pool ID.
+/// - Allocations are sampled with a probability proportional to their size (on average one every N bytes, with 
+///   exponentially distributed intervals), so the cost does not depend on the allocation rate.
+/// - Sampled allocations are attributed to a site (pool and call stack, or pool and thread tag), with live-heap 
+///   and churn statistics and size histograms.
+/// - Frees check a counting filter without locking; only frees of (probably) sampled allocations take the lock.
+/// The profiler tables are allocated with malloc(), so that the profiler never allocates from the pools it samples.
+
+#ifndef _AK_TOOLS_COMMON_AKALLOCSAMPLER_H
+#define _AK_TOOLS_COMMON_AKALLOCSAMPLER_H
+
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
+#include <AK/Tools/Common/AkAtomic.h>
+#include <AK/Tools/Common/AkLock.h>
+#include <AK/Tools/Common/AkAutoLock.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(AK_LINUX) && defined(__GLIBC__)
+#include <execinfo.h>
+#endif
+
+#if defined(_MSC_VER)
+#define AK_ALLOC_SAMPLER_THREAD_LOCAL __declspec(thread)
+#else
+#define AK_ALLOC_SAMPLER_THREAD_LOCAL __thread
+#endif
+
+/// Capture the return addresses of the calling thread. Override to support stack capture on other platforms.
+#ifndef AK_ALLOC_SAMPLER_CAPTURE_STACK
+#if defined(AK_LINUX) && defined(__GLIBC__)
+#define AK_ALLOC_SAMPLER_CAPTURE_STACK( _pFrames_, _uMaxFrames_ ) backtrace( (_pFrames_), (int)(_uMaxFrames_) )
+#else
+#define AK_ALLOC_SAMPLER_CAPTURE_STACK( _pFrames_, _uMaxFrames_ ) 0
+#endif
+#endif
+
+/// Maximum number of stack frames recorded per allocation site.
+#ifndef AK_ALLOC_SAMPLING_MAX_FRAMES
+#define AK_ALLOC_SAMPLING_MAX_FRAMES 16
+#endif
+
+/// Number of size classes in the histograms of allocation sites. Class i holds sizes in [2^(i+4), 2^(i+5)); 
+/// the first class also holds smaller sizes and the last one bigger sizes.
+#define AK_ALLOC_SAMPLING_NUM_SIZE_CLASSES 20
+
+/// Statistics of one allocation site.
+/// A site is a pool and a call stack, or a pool and a tag (see AkAllocSampler::SetThreadTag()) where stacks cannot be captured.
+/// Sample counts are raw; estimated values are corrected for the sampling rate.
+/// \sa 
+/// - AkAllocSampler::ForEachSite()
+struct AkAllocSite
+{
+	AkMemPoolId	poolId;										///< Pool of the allocations
+	AkUInt32	uTag;										///< Allocation tag of the thread when the site was first sampled
+	AkUInt32	uNumFrames;									///< Number of valid entries in pFrames
+	void *		pFrames[AK_ALLOC_SAMPLING_MAX_FRAMES];		///< Return addresses, innermost first
+
+	AkUInt32	uLiveSamples;								///< Sampled allocations not freed yet
+	AkUInt32	uTotalSamples;								///< Sampled allocations since sampling started
+	AkUInt64	uLiveSampledBytes;							///< Size of the sampled allocations not freed yet
+	AkUInt64	uTotalSampledBytes;							///< Size of all sampled allocations
+	AkReal64	fLiveBytes;									///< Estimated bytes currently allocated by this site
+	AkReal64	fLiveAllocs;								///< Estimated number of allocations currently live
+	AkReal64	fTotalBytes;								///< Estimated bytes allocated since sampling started (churn)
+	AkReal64	fTotalAllocs;								///< Estimated number of allocations since sampling started
+	AkUInt32	uLiveSizeHistogram[AK_ALLOC_SAMPLING_NUM_SIZE_CLASSES];		///< Live samples per size class
+	AkUInt32	uTotalSizeHistogram[AK_ALLOC_SAMPLING_NUM_SIZE_CLASSES];	///< All samples per size class
+};
+
+/// Global statistics of the sampling allocation profiler.
+/// \sa 
+/// - AkAllocSampler::GetStats()
+struct AkAllocSamplingStats
+{
+	AkUInt32	uSamplingInterval;		///< Mean number of bytes between samples (0 when sampling is stopped)
+	AkUInt32	uNumSamples;			///< Samples taken since sampling started
+	AkUInt32	uNumLiveSamples;		///< Samples not freed yet
+	AkUInt32	uNumSites;				///< Distinct allocation sites
+	AkUInt32	uNumDroppedSamples;		///< Samples not recorded because the site or live tables were full
+	AkReal64	fLiveBytes;				///< Estimated bytes currently allocated, all sites
+	AkReal64	fTotalBytes;			///< Estimated bytes allocated since sampling started, all sites
+};
+
+/// Callback function called for each site by AkAllocSampler::ForEachSite().
+typedef void ( *AkAllocSiteCallbackFunc )(
+	const AkAllocSite &	in_site,	///< Site statistics
+	void *				in_pCookie	///< User data passed to ForEachSite()
+	);
+
+// Per-thread sampling state.
+struct AkAllocSamplerThreadState
+{
+	AkInt64		iBytesUntilSample;	// Bytes to allocate before the next sample.
+	AkUInt64	uRandomState;		// xorshift64* state. 0 until the thread's first allocation.
+	AkUInt32	uTag;				// See AkAllocSampler::SetThreadTag().
+};
+
+inline AkAllocSamplerThreadState & AkGetAllocSamplerThreadState()
+{
+	static AK_ALLOC_SAMPLER_THREAD_LOCAL AkAllocSamplerThreadState s_state = { 0, 0, 0 };
+	return s_state;
+}
+
+template <class TLock = CAkLock>
+class AkAllocSampler
+{
+public:
+	AkAllocSampler()
+		: m_uSamplingInterval( 0 )
+		, m_pSites( NULL )
+		, m_pSiteIndex( NULL )
+		, m_pLive( NULL )
+		, m_pFilter( NULL )
+		, m_uSiteIndexMask( 0 )
+		, m_uLiveMask( 0 )
+		, m_uMaxSites( 0 )
+		, m_uMaxLiveSamples( 0 )
+	{
+		ClearCounters();
+	}
+
+	~AkAllocSampler()
+	{
+		AKASSERT( m_pSites == NULL );
+	}
+
+	/// Allocate the tables and start sampling. Must not run concurrently with other calls.
+	AKRESULT Init( AkUInt32 in_uSamplingInterval, AkUInt32 in_uMaxLiveSamples, AkUInt32 in_uMaxSites )
+	{
+		Term();
+		if ( in_uSamplingInterval == 0 || in_uMaxLiveSamples == 0 || in_uMaxSites == 0 )
+			return AK_InvalidParameter;
+
+		// Tables are at most half full, so probes stay short.
+		m_uSiteIndexMask = PowerOfTwo( in_uMaxSites * 2 ) - 1;
+		m_uLiveMask = PowerOfTwo( in_uMaxLiveSamples * 2 ) - 1;
+		m_uMaxSites = in_uMaxSites;
+		m_uMaxLiveSamples = in_uMaxLiveSamples;
+
+		m_pSites = (AkAllocSite*)malloc( sizeof( AkAllocSite ) * m_uMaxSites );
+		m_pSiteIndex = (AkUInt32*)malloc( sizeof( AkUInt32 ) * ( m_uSiteIndexMask + 1 ) );
+		m_pLive = (LiveSample*)malloc( sizeof( LiveSample ) * ( m_uLiveMask + 1 ) );
+		m_pFilter = (AkAtomic32*)malloc( sizeof( AkAtomic32 ) * ( m_uLiveMask + 1 ) );
+		if ( !m_pSites || !m_pSiteIndex || !m_pLive || !m_pFilter )
+		{
+			Term();
+			return AK_InsufficientMemory;
+		}
+
+		AKPLATFORM::AkMemSet( m_pSiteIndex, 0xFF, sizeof( AkUInt32 ) * ( m_uSiteIndexMask + 1 ) );
+		AKPLATFORM::AkMemSet( m_pLive, 0, sizeof( LiveSample ) * ( m_uLiveMask + 1 ) );
+		AKPLATFORM::AkMemSet( (void*)m_pFilter, 0, sizeof( AkAtomic32 ) * ( m_uLiveMask + 1 ) );
+		ClearCounters();
+		m_uSamplingInterval = in_uSamplingInterval;
+		return AK_Success;
+	}
+
+	/// Stop sampling and free the tables. No thread may allocate or free concurrently.
+	void Term()
+	{
+		m_uSamplingInterval = 0;
+		if ( m_pSites ) free( m_pSites );
+		if ( m_pSiteIndex ) free( m_pSiteIndex );
+		if ( m_pLive ) free( m_pLive );
+		if ( m_pFilter ) free( (void*)m_pFilter );
+		m_pSites = NULL;
+		m_pSiteIndex = NULL;
+		m_pLive = NULL;
+		m_pFilter = NULL;
+		m_uSiteIndexMask = 0;
+		m_uLiveMask = 0;
+		m_uMaxSites = 0;
+		m_uMaxLiveSamples = 0;
+		ClearCounters();
+	}
+
+	bool IsEnabled() const { return m_uSamplingInterval != 0; }
+
+	/// Set the tag of the calling thread's allocations.
+	static void SetThreadTag( AkUInt32 in_uTag ) { AkGetAllocSamplerThreadState().uTag = in_uTag; }
+
+	/// Fast path, called for every allocation. 
+	/// \return True if the allocation must be passed to RecordAlloc() once it succeeded.
+	AkForceInline bool ShouldSample( size_t in_uSize )
+	{
+		if ( m_uSamplingInterval == 0 )
+			return false;
+		AkAllocSamplerThreadState & state = AkGetAllocSamplerThreadState();
+		state.iBytesUntilSample -= (AkInt64)in_uSize;
+		return state.iBytesUntilSample <= 0;
+	}
+
+	/// Record a sampled allocation.
+	void RecordAlloc( 
+		AkMemPoolId in_poolId,		///< Pool of the allocation (in_poolId of AK::MemoryMgr::Malloc())
+		void * in_pAddress,			///< Allocated block
+		size_t in_uSize,			///< Requested size
+		AkUInt32 in_uSkipFrames = 1	///< Number of innermost frames to omit from the stack (the allocator's own frames)
+		)
+	{
+		AkAllocSamplerThreadState & state = AkGetAllocSamplerThreadState();
+		bool bFirstSample = ( state.uRandomState == 0 );
+		if ( bFirstSample )
+			state.uRandomState = ( (AkUInt64)(AkUIntPtr)&state * 0x9E3779B97F4A7C15ULL ) | 1;
+		state.iBytesUntilSample = NextInterval( state.uRandomState );
+		if ( bFirstSample || in_pAddress == NULL || !IsEnabled() )
+			return; // The thread's first interval was not drawn from the distribution: skip it.
+
+		void * pFrames[ AK_ALLOC_SAMPLING_MAX_FRAMES + 4 ];
+		AkUInt32 uNumFrames = (AkUInt32)AK_ALLOC_SAMPLER_CAPTURE_STACK( pFrames, AK_ALLOC_SAMPLING_MAX_FRAMES + 4 );
+		AkUInt32 uSkip = ( in_uSkipFrames + 1 < uNumFrames ) ? in_uSkipFrames + 1 : uNumFrames; // Also skip this function.
+		uNumFrames -= uSkip;
+		if ( uNumFrames > AK_ALLOC_SAMPLING_MAX_FRAMES )
+			uNumFrames = AK_ALLOC_SAMPLING_MAX_FRAMES;
+
+		AkUInt32 uSizeClass = SizeClass( in_uSize );
+		AkReal64 fWeight = SampleWeight( in_uSize );
+
+		AkAutoLock<TLock> lock( m_lock );
+		AkUInt32 uSite = FindOrAddSite( in_poolId, state.uTag, pFrames + uSkip, uNumFrames );
+		if ( uSite == AK_INVALID_SITE || m_uNumLiveSamples >= m_uMaxLiveSamples )
+		{
+			++m_uNumDroppedSamples;
+			return;
+		}
+
+		AkUInt32 uSlot = LiveSlot( in_pAddress );
+		while ( m_pLive[ uSlot ].pAddress != NULL && m_pLive[ uSlot ].pAddress != in_pAddress )
+			uSlot = ( uSlot + 1 ) & m_uLiveMask;
+		if ( m_pLive[ uSlot ].pAddress == in_pAddress )
+		{
+			// Block freed without RecordFree() (e.g. pool destroyed): forget the stale sample.
+			RemoveLiveAt( uSlot );
+			return RecordAllocLocked( uSite, in_pAddress, in_uSize, uSizeClass, fWeight );
+		}
+		RecordAllocLocked( uSite, in_pAddress, in_uSize, uSizeClass, fWeight );
+	}
+
+	/// Called for every free. Only takes the lock when the block is likely to be sampled.
+	AkForceInline void RecordFree( void * in_pAddress )
+	{
+		if ( m_pFilter == NULL || in_pAddress == NULL )
+			return;
+		if ( AKPLATFORM::AkAtomicLoad32( &m_pFilter[ LiveSlot( in_pAddress ) ], AkMemoryOrder_Relaxed ) == 0 )
+			return;
+		RemoveSample( in_pAddress );
+	}
+
+	void GetStats( AkAllocSamplingStats & out_stats )
+	{
+		AkAutoLock<TLock> lock( m_lock );
+		out_stats.uSamplingInterval = m_uSamplingInterval;
+		out_stats.uNumSamples = m_uNumSamples;
+		out_stats.uNumLiveSamples = m_uNumLiveSamples;
+		out_stats.uNumSites = m_uNumSites;
+		out_stats.uNumDroppedSamples = m_uNumDroppedSamples;
+		out_stats.fLiveBytes = 0;
+		out_stats.fTotalBytes = 0;
+		for ( AkUInt32 i = 0; i < m_uNumSites; ++i )
+		{
+			out_stats.fLiveBytes += m_pSites[ i ].fLiveBytes;
+			out_stats.fTotalBytes += m_pSites[ i ].fTotalBytes;
+		}
+	}
+
+	void ForEachSite( AkAllocSiteCallbackFunc in_pCallback, void * in_pCookie )
+	{
+		AkAutoLock<TLock> lock( m_lock );
+		for ( AkUInt32 i = 0; i < m_uNumSites; ++i )
+			in_pCallback( m_pSites[ i ], in_pCookie );
+	}
+
+	/// Write the sampled heap in the legacy pprof heap profile format (heap_v2). Counts are raw samples: pprof 
+	/// corrects them for the sampling interval written in the header.
+	AKRESULT WriteHeapProfile( FILE * in_pFile )
+	{
+		if ( in_pFile == NULL || !IsEnabled() )
+			return AK_Fail;
+
+		AkAutoLock<TLock> lock( m_lock );
+		AkUInt32 uLiveSamples = 0, uTotalSamples = 0;
+		AkUInt64 uLiveBytes = 0, uTotalBytes = 0;
+		for ( AkUInt32 i = 0; i < m_uNumSites; ++i )
+		{
+			uLiveSamples += m_pSites[ i ].uLiveSamples;
+			uTotalSamples += m_pSites[ i ].uTotalSamples;
+			uLiveBytes += m_pSites[ i ].uLiveSampledBytes;
+			uTotalBytes += m_pSites[ i ].uTotalSampledBytes;
+		}
+
+		fprintf( in_pFile, "heap profile: %u: %llu [%u: %llu] @ heap_v2/%u\n", 
+			uLiveSamples, (unsigned long long)uLiveBytes, uTotalSamples, (unsigned long long)uTotalBytes, m_uSamplingInterval );
+		for ( AkUInt32 i = 0; i < m_uNumSites; ++i )
+		{
+			const AkAllocSite & site = m_pSites[ i ];
+			fprintf( in_pFile, "%u: %llu [%u: %llu] @", 
+				site.uLiveSamples, (unsigned long long)site.uLiveSampledBytes, site.uTotalSamples, (unsigned long long)site.uTotalSampledBytes );
+			if ( site.uNumFrames == 0 )
+				fprintf( in_pFile, " 0x%x", site.uTag ); // Pseudo-address, so that tagged sites stay distinct.
+			for ( AkUInt32 uFrame = 0; uFrame < site.uNumFrames; ++uFrame )
+				fprintf( in_pFile, " %p", site.pFrames[ uFrame ] );
+			fprintf( in_pFile, "\n" );
+		}
+
+#if defined(AK_LINUX)
+		// pprof needs the mappings to symbolize addresses of shared objects.
+		FILE * pMaps = fopen( "/proc/self/maps", "r" );
+		if ( pMaps )
+		{
+			fprintf( in_pFile, "\nMAPPED_LIBRARIES:\n" );
+			char buffer[ 4096 ];
+			size_t uRead;
+			while ( ( uRead = fread( buffer, 1, sizeof( buffer ), pMaps ) ) > 0 )
+				fwrite( buffer, 1, uRead, in_pFile );
+			fclose( pMaps );
+		}
+#endif
+		return ferror( in_pFile ) ? AK_Fail : AK_Success;
+	}
+
+private:
+	enum { AK_INVALID_SITE = 0xFFFFFFFF };
+
+	struct LiveSample
+	{
+		void *		pAddress;	// NULL when the slot is free.
+		AkUInt32	uSite;
+		AkUInt32	uSize;
+	};
+
+	static AkUInt32 PowerOfTwo( AkUInt32 in_uValue )
+	{
+		AkUInt32 uPow = 1;
+		while ( uPow < in_uValue )
+			uPow <<= 1;
+		return uPow;
+	}
+
+	static AkUInt32 SizeClass( size_t in_uSize )
+	{
+		AkUInt32 uClass = 0;
+		size_t uSize = in_uSize >> 5;
+		while ( uSize && uClass < AK_ALLOC_SAMPLING_NUM_SIZE_CLASSES - 1 )
+		{
+			++uClass;
+			uSize >>= 1;
+		}
+		return uClass;
+	}
+
+	// Expected number of allocations represented by a sample of this size: 1 / P(sampled).
+	AkReal64 SampleWeight( size_t in_uSize ) const
+	{
+		AkReal64 fProbability = 1.0 - exp( -(AkReal64)in_uSize / (AkReal64)m_uSamplingInterval );
+		return ( fProbability > 0.0 ) ? 1.0 / fProbability : (AkReal64)m_uSamplingInterval;
+	}
+
+	// Exponentially distributed interval, so that each byte has the same probability of being sampled.
+	AkInt64 NextInterval( AkUInt64 & io_uRandomState ) const
+	{
+		io_uRandomState ^= io_uRandomState >> 12;
+		io_uRandomState ^= io_uRandomState << 25;
+		io_uRandomState ^= io_uRandomState >> 27;
+		AkUInt64 uRandom = io_uRandomState * 0x2545F4914F6CDD1DULL;
+		AkReal64 fUniform = ( (AkReal64)( uRandom >> 11 ) + 1.0 ) * ( 1.0 / 9007199254740992.0 ); // (0, 1]
+		AkInt64 iInterval = (AkInt64)( -log( fUniform ) * (AkReal64)m_uSamplingInterval );
+		return ( iInterval > 0 ) ? iInterval : 1;
+	}
+
+	AkUInt32 LiveSlot( void * in_pAddress ) const
+	{
+		AkUInt64 uHash = (AkUInt64)(AkUIntPtr)in_pAddress * 0x9E3779B97F4A7C15ULL;
+		return (AkUInt32)( uHash >> 32 ) & m_uLiveMask;
+	}
+
+	static AkUInt32 HashSite( AkMemPoolId in_poolId, AkUInt32 in_uTag, void * const * in_pFrames, AkUInt32 in_uNumFrames )
+	{
+		AkUInt64 uHash = 0xCBF29CE484222325ULL ^ (AkUInt64)(AkUInt32)in_poolId;
+		uHash = ( uHash ^ in_uTag ) * 0x100000001B3ULL;
+		for ( AkUInt32 i = 0; i < in_uNumFrames; ++i )
+			uHash = ( uHash ^ (AkUInt64)(AkUIntPtr)in_pFrames[ i ] ) * 0x100000001B3ULL;
+		return (AkUInt32)( uHash ^ ( uHash >> 32 ) );
+	}
+
+	AkUInt32 FindOrAddSite( AkMemPoolId in_poolId, AkUInt32 in_uTag, void * const * in_pFrames, AkUInt32 in_uNumFrames )
+	{
+		// The tag only distinguishes sites without a stack.
+		AkUInt32 uTag = ( in_uNumFrames == 0 ) ? in_uTag : 0;
+		AkUInt32 uSlot = HashSite( in_poolId, uTag, in_pFrames, in_uNumFrames ) & m_uSiteIndexMask;
+		for ( ;; uSlot = ( uSlot + 1 ) & m_uSiteIndexMask )
+		{
+			AkUInt32 uSite = m_pSiteIndex[ uSlot ];
+			if ( uSite == AK_INVALID_SITE )
+				break;
+			const AkAllocSite & site = m_pSites[ uSite ];
+			if ( site.poolId == in_poolId && site.uNumFrames == in_uNumFrames && ( in_uNumFrames || site.uTag == uTag )
+				&& memcmp( site.pFrames, in_pFrames, in_uNumFrames * sizeof( void* ) ) == 0 )
+				return uSite;
+		}
+
+		if ( m_uNumSites >= m_uMaxSites )
+			return AK_INVALID_SITE;
+
+		AkUInt32 uSite = m_uNumSites++;
+		AkAllocSite & site = m_pSites[ uSite ];
+		AKPLATFORM::AkMemSet( &site, 0, sizeof( site ) );
+		site.poolId = in_poolId;
+		site.uTag = in_uTag;
+		site.uNumFrames = in_uNumFrames;
+		AKPLATFORM::AkMemCpy( site.pFrames, in_pFrames, in_uNumFrames * sizeof( void* ) );
+		m_pSiteIndex[ uSlot ] = uSite;
+		return uSite;
+	}
+
+	void RecordAllocLocked( AkUInt32 in_uSite, void * in_pAddress, size_t in_uSize, AkUInt32 in_uSizeClass, AkReal64 in_fWeight )
+	{
+		AkUInt32 uSlot = LiveSlot( in_pAddress );
+		AKPLATFORM::AkAtomicFetchAdd32( &m_pFilter[ uSlot ], 1, AkMemoryOrder_Relaxed );
+		while ( m_pLive[ uSlot ].pAddress != NULL )
+			uSlot = ( uSlot + 1 ) & m_uLiveMask;
+		m_pLive[ uSlot ].pAddress = in_pAddress;
+		m_pLive[ uSlot ].uSite = in_uSite;
+		m_pLive[ uSlot ].uSize = ( in_uSize < 0xFFFFFFFF ) ? (AkUInt32)in_uSize : 0xFFFFFFFF;
+		++m_uNumLiveSamples;
+		++m_uNumSamples;
+
+		AkAllocSite & site = m_pSites[ in_uSite ];
+		site.uLiveSamples++;
+		site.uTotalSamples++;
+		site.uLiveSampledBytes += in_uSize;
+		site.uTotalSampledBytes += in_uSize;
+		site.fLiveBytes += in_fWeight * (AkReal64)in_uSize;
+		site.fLiveAllocs += in_fWeight;
+		site.fTotalBytes += in_fWeight * (AkReal64)in_uSize;
+		site.fTotalAllocs += in_fWeight;
+		site.uLiveSizeHistogram[ in_uSizeClass ]++;
+		site.uTotalSizeHistogram[ in_uSizeClass ]++;
+	}
+
+	void RemoveSample( void * in_pAddress )
+	{
+		AkAutoLock<TLock> lock( m_lock );
+		if ( m_pLive == NULL )
+			return;
+		for ( AkUInt32 uSlot = LiveSlot( in_pAddress ); m_pLive[ uSlot ].pAddress != NULL; uSlot = ( uSlot + 1 ) & m_uLiveMask )
+		{
+			if ( m_pLive[ uSlot ].pAddress == in_pAddress )
+			{
+				RemoveLiveAt( uSlot );
+				return;
+			}
+		}
+	}
+
+	void RemoveLiveAt( AkUInt32 in_uSlot )
+	{
+		const LiveSample & sample = m_pLive[ in_uSlot ];
+		AkAllocSite & site = m_pSites[ sample.uSite ];
+		AkReal64 fWeight = SampleWeight( sample.uSize );
+		site.uLiveSamples--;
+		site.uLiveSampledBytes -= sample.uSize;
+		site.fLiveBytes -= fWeight * (AkReal64)sample.uSize;
+		site.fLiveAllocs -= fWeight;
+		site.uLiveSizeHistogram[ SizeClass( sample.uSize ) ]--;
+		AKPLATFORM::AkAtomicFetchAdd32( &m_pFilter[ LiveSlot( sample.pAddress ) ], -1, AkMemoryOrder_Relaxed );
+		--m_uNumLiveSamples;
+
+		// Backward-shift deletion: move up entries whose probe sequence crosses the freed slot.
+		AkUInt32 uHole = in_uSlot;
+		AkUInt32 uSlot = in_uSlot;
+		for ( ;; )
+		{
+			uSlot = ( uSlot + 1 ) & m_uLiveMask;
+			if ( m_pLive[ uSlot ].pAddress == NULL )
+				break;
+			AkUInt32 uHome = LiveSlot( m_pLive[ uSlot ].pAddress );
+			if ( ( ( uSlot - uHome ) & m_uLiveMask ) >= ( ( uSlot - uHole ) & m_uLiveMask ) )
+			{
+				m_pLive[ uHole ] = m_pLive[ uSlot ];
+				uHole = uSlot;
+			}
+		}
+		m_pLive[ uHole ].pAddress = NULL;
+	}
+
+	void ClearCounters()
+	{
+		m_uNumSites = 0;
+		m_uNumSamples = 0;
+		m_uNumLiveSamples = 0;
+		m_uNumDroppedSamples = 0;
+	}
+
+	TLock						m_lock;
+	AkUInt32					m_uSamplingInterval;	// Mean bytes between samples. 0 when stopped.
+	AkAllocSite *	m_pSites;				// Dense array of m_uMaxSites sites.
+	AkUInt32 *					m_pSiteIndex;			// Open-addressing index into m_pSites.
+	LiveSample *				m_pLive;				// Open-addressing table of live samples, by address.
+	AkAtomic32 *				m_pFilter;				// Live samples per home slot of m_pLive, read without locking by RecordFree().
+	AkUInt32					m_uSiteIndexMask;
+	AkUInt32					m_uLiveMask;
+	AkUInt32					m_uMaxSites;
+	AkUInt32					m_uMaxLiveSamples;
+	AkUInt32					m_uNumSites;
+	AkUInt32					m_uNumSamples;
+	AkUInt32					m_uNumLiveSamples;
+	AkUInt32					m_uNumDroppedSamples;
+};
+
+#endif // _AK_TOOLS_COMMON_AKALLOCSAMPLER_H
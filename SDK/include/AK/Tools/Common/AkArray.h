@@ -32,6 +32,8 @@ the specific language governing permissions and limitations under the License.
 #include <AK/Tools/Common/AkAssert.h>
 #include <AK/Tools/Common/AkPlatformFuncs.h>
 
+#include <string.h>
+
 #define AK_DEFINE_ARRAY_POOL( _name_, _poolID_ )	\
 struct _name_										\
 {													\
@@ -143,6 +145,45 @@ struct AkTransferMovePolicy
 	}
 };
 
+// Can be used as TMovePolicy for trivially relocatable types: types that remain valid when their bytes are moved to another address, 
+//	and need no destructor call on the source afterwards (PODs, but also most types owning a pointer to a resource).
+//	Reallocations, insertions and erasures then move whole blocks of items with memcpy/memmove instead of one item at a time.
+template <class T>
+struct AkRelocateMovePolicy
+{
+	static AkForceInline void Move( T& in_Dest, T& in_Src )
+	{
+		AKPLATFORM::AkMemCpy( &in_Dest, &in_Src, sizeof( T ) );
+	}
+};
+
+// Tells AkArray whether TMovePolicy moves items as raw bytes. Specialize it for custom move policies that do.
+template <class TMovePolicy>
+struct AkIsRelocateMovePolicy
+{
+	enum { Value = false };
+};
+
+template <class T>
+struct AkIsRelocateMovePolicy< AkRelocateMovePolicy<T> >
+{
+	enum { Value = true };
+};
+
+// Pass as TGrowBy to grow an AkArray geometrically, by half its reserved size (at least AK_ARRAY_MIN_GEOMETRIC_GROWTH items),
+//	so that building a large array costs amortized constant time per item instead of quadratic copying.
+const unsigned long AkGrowByGeometric = 0xFFFFFFFF;
+
+#ifndef AK_ARRAY_MIN_GEOMETRIC_GROWTH
+#define AK_ARRAY_MIN_GEOMETRIC_GROWTH 4
+#endif
+
+// Define AK_ARRAY_TRACK_REALLOCS to count reallocations per AkArray instantiation (see AkArray::GetNumReallocs()).
+//	AK_ARRAY_ON_REALLOC( _uOldReserved_, _uNewReserved_, _uItemSize_ ) may also be defined to hook reallocations, for example to record callstacks.
+#ifndef AK_ARRAY_ON_REALLOC
+#define AK_ARRAY_ON_REALLOC( _uOldReserved_, _uNewReserved_, _uItemSize_ )
+#endif
+
 // Common allocators:
 typedef AkArrayAllocatorNoAlign<_ArrayPoolDefault> ArrayPoolDefault;
 typedef AkArrayAllocatorNoAlign<_ArrayPoolLEngineDefault> ArrayPoolLEngineDefault;
@@ -275,6 +316,12 @@ public:
 	{
 		AKASSERT( m_pItems != 0 );
 
+		if ( AkIsRelocateMovePolicy<TMovePolicy>::Value )
+		{
+			EraseRelocate( (AkUInt32)( in_rIter.pItem - m_pItems ) );
+			return in_rIter;
+		}
+
 		// Move items by 1
 
 		T * pItemLast = m_pItems + m_uLength - 1;
@@ -296,6 +343,12 @@ public:
 	{
 		AKASSERT( m_pItems != 0 );
 
+		if ( AkIsRelocateMovePolicy<TMovePolicy>::Value )
+		{
+			EraseRelocate( in_uIndex );
+			return;
+		}
+
 		// Move items by 1
 
 		T * pItemLast = m_pItems + m_uLength - 1;
@@ -316,6 +369,16 @@ public:
 	{
 		AKASSERT( m_pItems != 0 );
 
+		if ( AkIsRelocateMovePolicy<TMovePolicy>::Value )
+		{
+			// Destroy this item, and relocate the last item in its place.
+			in_rIter.pItem->~T();
+			if ( in_rIter.pItem != &Last( ) )
+				AKPLATFORM::AkMemCpy( in_rIter.pItem, &Last( ), sizeof( T ) );
+			m_uLength--;
+			return in_rIter;
+		}
+
 		if ( Length( ) > 1 )
 		{
 			// Swap last item with this one.
@@ -331,10 +394,18 @@ public:
 		return in_rIter;
 	}
 
-	/// Pre-Allocate a number of spaces in the array
+	/// Pre-Allocate a number of spaces in the array.
+	/// On an array that already has items, grows the array to at least in_ulReserve spaces (never shrinks it).
 	AKRESULT Reserve( AkUInt32 in_ulReserve )
 	{
-		AKASSERT( m_pItems == 0 && m_uLength == 0 );
+		if ( m_pItems )
+		{
+			if ( in_ulReserve > m_ulReserved && !GrowArray( in_ulReserve - m_ulReserved ) )
+				return AK_InsufficientMemory;
+			return AK_Success;
+		}
+
+		AKASSERT( m_uLength == 0 );
 		AKASSERT( in_ulReserve || TGrowBy );
 
 		if ( in_ulReserve )
@@ -421,6 +492,41 @@ public:
 		return pItem;
 	}
 
+	/// Add in_uCount items at the end of the array, copied from in_pItems, growing the array at most once.
+	/// Returns a pointer to the first added item, or NULL if the array could not grow (no item is added then).
+	T * AddLast(const T * in_pItems, AkUInt32 in_uCount)
+	{
+		AkUInt32 cItems = Length();
+		if ( cItems + in_uCount > m_ulReserved )
+		{
+			AkUInt32 uGrowBy = GetGrowBy();
+			if ( uGrowBy == 0 )
+				return 0;
+			if ( uGrowBy < cItems + in_uCount - m_ulReserved )
+				uGrowBy = cItems + in_uCount - m_ulReserved;
+			if ( !GrowArray( uGrowBy ) )
+				return 0;
+		}
+
+		T * pFirst = m_pItems + cItems;
+		if ( AkIsRelocateMovePolicy<TMovePolicy>::Value )
+		{
+			if ( in_uCount )
+				AKPLATFORM::AkMemCpy( pFirst, in_pItems, (AkUInt32)( sizeof( T ) * in_uCount ) );
+		}
+		else
+		{
+			for ( AkUInt32 i = 0; i < in_uCount; ++i )
+			{
+				AkPlacementNew( pFirst + i ) T;
+				pFirst[ i ] = in_pItems[ i ];
+			}
+		}
+		m_uLength += in_uCount;
+
+		return pFirst;
+	}
+
 	/// Returns a reference to the last item in the array.
 	T& Last()
 	{
@@ -502,6 +608,16 @@ public:
 #endif
 
 		// have we got space for a new one ?
+		if(  cItems < m_ulReserved && AkIsRelocateMovePolicy<TMovePolicy>::Value )
+		{
+			// Move items by 1, as a block.
+			T * pItem = m_pItems + in_uIndex;
+			memmove( (void*)( pItem + 1 ), (void*)pItem, sizeof( T ) * ( m_uLength - in_uIndex ) );
+			m_uLength++;
+			AkPlacementNew( pItem ) T; 
+			return pItem;
+		}
+
 		if(  cItems < m_ulReserved )
 		{
 			T * pItemLast = m_pItems + m_uLength++;
@@ -523,8 +639,32 @@ public:
 		return 0;
 	}
 
+	/// Number of spaces added when the array is full, according to TGrowBy.
+	AkUInt32 GetGrowBy() const
+	{
+#if defined(_MSC_VER)
+#pragma warning( push )
+#pragma warning( disable : 4127 )
+#endif
+		if ( TGrowBy == AkGrowByGeometric )
+		{
+			AkUInt32 uGrowBy = m_ulReserved / 2;
+			return ( uGrowBy > AK_ARRAY_MIN_GEOMETRIC_GROWTH ) ? uGrowBy : AK_ARRAY_MIN_GEOMETRIC_GROWTH;
+		}
+#if defined(_MSC_VER)
+#pragma warning( pop )
+#endif
+		return (AkUInt32)TGrowBy;
+	}
+
+	/// Resize the array, by TGrowBy spaces.
+	bool GrowArray()
+	{
+		return GrowArray( GetGrowBy() );
+	}
+
 	/// Resize the array.
-	bool GrowArray( AkUInt32 in_uGrowBy = TGrowBy )
+	bool GrowArray( AkUInt32 in_uGrowBy )
 	{
 		AKASSERT( in_uGrowBy );
 		
@@ -539,16 +679,29 @@ public:
 
 		if ( m_pItems && m_pItems != pNewItems /*AkHybridAllocator may serve up same memory*/ ) 
 		{
-			for ( size_t i = 0; i < cItems; ++i )
+			if ( AkIsRelocateMovePolicy<TMovePolicy>::Value )
 			{
-				AkPlacementNew( pNewItems + i ) T; 
+				if ( cItems )
+					AKPLATFORM::AkMemCpy( pNewItems, m_pItems, (AkUInt32)( sizeof( T ) * cItems ) );
+			}
+			else
+			{
+				for ( size_t i = 0; i < cItems; ++i )
+				{
+					AkPlacementNew( pNewItems + i ) T; 
 
-				TMovePolicy::Move( pNewItems[ i ], m_pItems[ i ] );
-	            
-				m_pItems[ i ].~T();
+					TMovePolicy::Move( pNewItems[ i ], m_pItems[ i ] );
+		            
+					m_pItems[ i ].~T();
+				}
 			}
 
 			TAlloc::Free( m_pItems );
+
+#ifdef AK_ARRAY_TRACK_REALLOCS
+			AKPLATFORM::AkInterlockedIncrement( &s_iNumReallocs );
+#endif
+			AK_ARRAY_ON_REALLOC( m_ulReserved, ulNewReserve, (AkUInt32)sizeof( T ) );
 		}
 
 		m_pItems = pNewItems;
@@ -557,6 +710,12 @@ public:
 		return true;
 	}
 
+#ifdef AK_ARRAY_TRACK_REALLOCS
+	/// Number of reallocations (growth of a non-empty array) of all arrays of this instantiation.
+	static AkUInt32 GetNumReallocs() { return (AkUInt32)s_iNumReallocs; }
+	static void ResetNumReallocs() { s_iNumReallocs = 0; }
+#endif
+
 	/// Resize the array to the specified size.
 	bool Resize(AkUInt32 in_uiSize)
 	{
@@ -616,10 +775,28 @@ public:
 
 protected:
 
+	// Erase for relocatable items: destroy the item, and move the following ones by 1, as a block.
+	void EraseRelocate( AkUInt32 in_uIndex )
+	{
+		T * pItem = m_pItems + in_uIndex;
+		pItem->~T();
+		memmove( (void*)pItem, (void*)( pItem + 1 ), sizeof( T ) * ( m_uLength - in_uIndex - 1 ) );
+		m_uLength--;
+	}
+
 	T *         m_pItems;		///< pointer to the beginning of the array.
 	AkUInt32    m_uLength;		///< number of items in the array.
 	AkUInt32	m_ulReserved;	///< how many we can have at most (currently allocated).
+
+#ifdef AK_ARRAY_TRACK_REALLOCS
+	static AkAtomic32 s_iNumReallocs;
+#endif
 };
 
+#ifdef AK_ARRAY_TRACK_REALLOCS
+template <class T, class ARG_T, class TAlloc, unsigned long TGrowBy, class TMovePolicy>
+AkAtomic32 AkArray<T, ARG_T, TAlloc, TGrowBy, TMovePolicy>::s_iNumReallocs = 0;
+#endif
+
 
 #endif
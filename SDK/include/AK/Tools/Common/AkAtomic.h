@@ -0,0 +1,254 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkAtomic.h
+
+/// \file 
+/// Atomic operations with explicit memory ordering.
+/// Unlike AkInterlockedIncrement() and friends, which always imply a full barrier, these let the caller pick the weakest ordering 
+/// that is correct, for example relaxed for statistics counters, or acquire/release for reference counts and single-producer queues.
+/// They operate on the existing AkAtomic32, AkAtomic64 and AkAtomicPtr types.
+
+#ifndef _AK_TOOLS_COMMON_AKATOMIC_H
+#define _AK_TOOLS_COMMON_AKATOMIC_H
+
+#include <AK/Tools/Common/AkPlatformFuncs.h>
+
+/// Memory ordering constraints of atomic operations. Same semantics as std::memory_order.
+enum AkMemoryOrder
+{
+	AkMemoryOrder_Relaxed,	///< No ordering constraint, only atomicity.
+	AkMemoryOrder_Acquire,	///< Loads and read-modify-writes: later memory accesses cannot be reordered before this operation.
+	AkMemoryOrder_Release,	///< Stores and read-modify-writes: earlier memory accesses cannot be reordered after this operation.
+	AkMemoryOrder_AcqRel,	///< Read-modify-writes: both acquire and release.
+	AkMemoryOrder_SeqCst	///< Acquire and release, plus a single total order of all sequentially consistent operations. Same as AkInterlocked*().
+};
+
+namespace AKPLATFORM
+{
+#if defined(AK_USE_STD_ATOMIC) && defined(__clang__)
+	// AkAtomic types are C11 _Atomic types.
+	#define AK_ATOMIC_ORDER( _eOrder_ )									AKPLATFORM::AkAtomicOrderToBuiltin( _eOrder_ )
+	#define AK_ATOMIC_LOAD( _pSrc_, _eOrder_ )							__c11_atomic_load( _pSrc_, AK_ATOMIC_ORDER( _eOrder_ ) )
+	#define AK_ATOMIC_STORE( _pDest_, _value_, _eOrder_ )				__c11_atomic_store( _pDest_, _value_, AK_ATOMIC_ORDER( _eOrder_ ) )
+	#define AK_ATOMIC_FETCH_ADD( _pDest_, _value_, _eOrder_ )			__c11_atomic_fetch_add( _pDest_, _value_, AK_ATOMIC_ORDER( _eOrder_ ) )
+	#define AK_ATOMIC_EXCHANGE( _pDest_, _value_, _eOrder_ )			__c11_atomic_exchange( _pDest_, _value_, AK_ATOMIC_ORDER( _eOrder_ ) )
+	#define AK_ATOMIC_CAS( _pDest_, _pExpected_, _value_, _eOrder_ )	__c11_atomic_compare_exchange_strong( _pDest_, _pExpected_, _value_, AK_ATOMIC_ORDER( _eOrder_ ), AK_ATOMIC_ORDER( AkAtomicFailureOrder( _eOrder_ ) ) )
+	#define AK_ATOMIC_FENCE( _eOrder_ )									__c11_atomic_thread_fence( AK_ATOMIC_ORDER( _eOrder_ ) )
+#elif defined(__GNUC__) || defined(__clang__)
+	#define AK_ATOMIC_ORDER( _eOrder_ )									AKPLATFORM::AkAtomicOrderToBuiltin( _eOrder_ )
+	#define AK_ATOMIC_LOAD( _pSrc_, _eOrder_ )							__atomic_load_n( _pSrc_, AK_ATOMIC_ORDER( _eOrder_ ) )
+	#define AK_ATOMIC_STORE( _pDest_, _value_, _eOrder_ )				__atomic_store_n( _pDest_, _value_, AK_ATOMIC_ORDER( _eOrder_ ) )
+	#define AK_ATOMIC_FETCH_ADD( _pDest_, _value_, _eOrder_ )			__atomic_fetch_add( _pDest_, _value_, AK_ATOMIC_ORDER( _eOrder_ ) )
+	#define AK_ATOMIC_EXCHANGE( _pDest_, _value_, _eOrder_ )			__atomic_exchange_n( _pDest_, _value_, AK_ATOMIC_ORDER( _eOrder_ ) )
+	#define AK_ATOMIC_CAS( _pDest_, _pExpected_, _value_, _eOrder_ )	__atomic_compare_exchange_n( _pDest_, _pExpected_, _value_, false, AK_ATOMIC_ORDER( _eOrder_ ), AK_ATOMIC_ORDER( AkAtomicFailureOrder( _eOrder_ ) ) )
+	#define AK_ATOMIC_FENCE( _eOrder_ )									__atomic_thread_fence( AK_ATOMIC_ORDER( _eOrder_ ) )
+#endif
+
+#ifdef AK_ATOMIC_ORDER
+	AkForceInline int AkAtomicOrderToBuiltin( AkMemoryOrder in_eOrder )
+	{
+		switch ( in_eOrder )
+		{
+		case AkMemoryOrder_Relaxed:	return __ATOMIC_RELAXED;
+		case AkMemoryOrder_Acquire:	return __ATOMIC_ACQUIRE;
+		case AkMemoryOrder_Release:	return __ATOMIC_RELEASE;
+		case AkMemoryOrder_AcqRel:	return __ATOMIC_ACQ_REL;
+		default:					return __ATOMIC_SEQ_CST;
+		}
+	}
+
+	// Ordering of the load performed by a failed compare-exchange: it cannot have release semantics.
+	AkForceInline AkMemoryOrder AkAtomicFailureOrder( AkMemoryOrder in_eOrder )
+	{
+		return ( in_eOrder == AkMemoryOrder_SeqCst ) ? AkMemoryOrder_SeqCst 
+			: ( in_eOrder == AkMemoryOrder_Acquire || in_eOrder == AkMemoryOrder_AcqRel ) ? AkMemoryOrder_Acquire 
+			: AkMemoryOrder_Relaxed;
+	}
+
+	#define AK_DEFINE_ATOMIC_OPS( _Suffix_, _AtomicType_, _ValueType_ )																		\
+	/** Atomically read *in_pSrc. in_eOrder must not be AkMemoryOrder_Release nor AkMemoryOrder_AcqRel. */									\
+	AkForceInline _ValueType_ AkAtomicLoad##_Suffix_( volatile _AtomicType_ * in_pSrc, AkMemoryOrder in_eOrder = AkMemoryOrder_SeqCst )		\
+	{																																		\
+		return AK_ATOMIC_LOAD( in_pSrc, in_eOrder );																						\
+	}																																		\
+	/** Atomically write *io_pDest. in_eOrder must not be AkMemoryOrder_Acquire nor AkMemoryOrder_AcqRel. */								\
+	AkForceInline void AkAtomicStore##_Suffix_( volatile _AtomicType_ * io_pDest, _ValueType_ in_value, AkMemoryOrder in_eOrder = AkMemoryOrder_SeqCst ) \
+	{																																		\
+		AK_ATOMIC_STORE( io_pDest, in_value, in_eOrder );																					\
+	}																																		\
+	/** Atomically add in_value to *io_pDest. Returns the previous value. */																\
+	AkForceInline _ValueType_ AkAtomicFetchAdd##_Suffix_( volatile _AtomicType_ * io_pDest, _ValueType_ in_value, AkMemoryOrder in_eOrder = AkMemoryOrder_SeqCst ) \
+	{																																		\
+		return AK_ATOMIC_FETCH_ADD( io_pDest, in_value, in_eOrder );																		\
+	}																																		\
+	/** Atomically replace *io_pDest by in_value. Returns the previous value. */															\
+	AkForceInline _ValueType_ AkAtomicExchange##_Suffix_( volatile _AtomicType_ * io_pDest, _ValueType_ in_value, AkMemoryOrder in_eOrder = AkMemoryOrder_SeqCst ) \
+	{																																		\
+		return AK_ATOMIC_EXCHANGE( io_pDest, in_value, in_eOrder );																			\
+	}																																		\
+	/** Atomically replace *io_pDest by in_value if it equals io_expected. Returns true if replaced; otherwise, io_expected receives the current value. */ \
+	AkForceInline bool AkAtomicCompareExchange##_Suffix_( volatile _AtomicType_ * io_pDest, _ValueType_ & io_expected, _ValueType_ in_value, AkMemoryOrder in_eOrder = AkMemoryOrder_SeqCst ) \
+	{																																		\
+		return AK_ATOMIC_CAS( io_pDest, &io_expected, in_value, in_eOrder );																\
+	}
+
+	AK_DEFINE_ATOMIC_OPS( 32, AkAtomic32, AkInt32 )
+	AK_DEFINE_ATOMIC_OPS( 64, AkAtomic64, AkInt64 )
+	AK_DEFINE_ATOMIC_OPS( Ptr, AkAtomicPtr, AkIntPtr )
+
+	#undef AK_DEFINE_ATOMIC_OPS
+
+	/// Memory fence with the specified ordering.
+	AkForceInline void AkAtomicThreadFence( AkMemoryOrder in_eOrder = AkMemoryOrder_SeqCst )
+	{
+		AK_ATOMIC_FENCE( in_eOrder );
+	}
+
+#elif defined(_MSC_VER)
+	// Interlocked functions are full barriers. Plain loads and stores go through __iso_volatile_load/store, which are single-copy atomic 
+	// for 32 and 64-bit values on all targets, including 64-bit values on x86.
+	// On x86/x64, aligned loads have acquire semantics and aligned stores have release semantics: only compiler reordering must be prevented.
+	// On ARM, acquire and release orderings require a data memory barrier.
+#if defined(_M_IX86) || defined(_M_X64)
+	#define AK_ATOMIC_MSVC_BARRIER( _eOrder_ )	_ReadWriteBarrier()
+#elif defined(_M_ARM64) || defined(_M_ARM)
+	#if defined(_M_ARM64)
+		#define AK_ATOMIC_MSVC_DMB()	__dmb( _ARM64_BARRIER_ISH )
+	#else
+		#define AK_ATOMIC_MSVC_DMB()	__dmb( _ARM_BARRIER_ISH )
+	#endif
+	#define AK_ATOMIC_MSVC_BARRIER( _eOrder_ )	do { if ( ( _eOrder_ ) != AkMemoryOrder_Relaxed ) AK_ATOMIC_MSVC_DMB(); else _ReadWriteBarrier(); } while ( 0 )
+#else
+	#error AkAtomic.h: Unsupported MSVC target
+#endif
+
+	template <class T_ATOMIC, class T_VALUE> struct AkAtomicMsvc;
+
+	template <> struct AkAtomicMsvc<AkAtomic32, AkInt32>
+	{
+		static AkForceInline AkInt32 Load( volatile AkAtomic32 * p ) { return __iso_volatile_load32( (volatile __int32*)p ); }
+		static AkForceInline void Store( volatile AkAtomic32 * p, AkInt32 v ) { __iso_volatile_store32( (volatile __int32*)p, v ); }
+		static AkForceInline AkInt32 FetchAdd( volatile AkAtomic32 * p, AkInt32 v ) { return _InterlockedExchangeAdd( (volatile long*)p, v ); }
+		static AkForceInline AkInt32 Exchange( volatile AkAtomic32 * p, AkInt32 v ) { return _InterlockedExchange( (volatile long*)p, v ); }
+		static AkForceInline AkInt32 CompareExchange( volatile AkAtomic32 * p, AkInt32 v, AkInt32 e ) { return _InterlockedCompareExchange( (volatile long*)p, v, e ); }
+	};
+
+	template <> struct AkAtomicMsvc<AkAtomic64, AkInt64>
+	{
+		static AkForceInline AkInt64 Load( volatile AkAtomic64 * p ) { return __iso_volatile_load64( (volatile __int64*)p ); }
+		static AkForceInline void Store( volatile AkAtomic64 * p, AkInt64 v ) { __iso_volatile_store64( (volatile __int64*)p, v ); }
+		static AkForceInline AkInt64 CompareExchange( volatile AkAtomic64 * p, AkInt64 v, AkInt64 e ) { return _InterlockedCompareExchange64( p, v, e ); }
+#if defined(_M_IX86)
+		// _InterlockedExchangeAdd64 and _InterlockedExchange64 are not intrinsics on x86.
+		static AkForceInline AkInt64 FetchAdd( volatile AkAtomic64 * p, AkInt64 v )
+		{
+			AkInt64 prev = Load( p );
+			for ( ;; )
+			{
+				const AkInt64 cur = _InterlockedCompareExchange64( p, prev + v, prev );
+				if ( cur == prev )
+					return prev;
+				prev = cur;
+			}
+		}
+		static AkForceInline AkInt64 Exchange( volatile AkAtomic64 * p, AkInt64 v )
+		{
+			AkInt64 prev = Load( p );
+			for ( ;; )
+			{
+				const AkInt64 cur = _InterlockedCompareExchange64( p, v, prev );
+				if ( cur == prev )
+					return prev;
+				prev = cur;
+			}
+		}
+#else
+		static AkForceInline AkInt64 FetchAdd( volatile AkAtomic64 * p, AkInt64 v ) { return _InterlockedExchangeAdd64( p, v ); }
+		static AkForceInline AkInt64 Exchange( volatile AkAtomic64 * p, AkInt64 v ) { return _InterlockedExchange64( p, v ); }
+#endif
+	};
+
+	#define AK_DEFINE_ATOMIC_OPS( _Suffix_, _AtomicType_, _ValueType_, _ImplAtomicType_, _ImplValueType_ )									\
+	AkForceInline _ValueType_ AkAtomicLoad##_Suffix_( volatile _AtomicType_ * in_pSrc, AkMemoryOrder in_eOrder = AkMemoryOrder_SeqCst )		\
+	{																																		\
+		_ValueType_ value = (_ValueType_)AkAtomicMsvc<_ImplAtomicType_, _ImplValueType_>::Load( (volatile _ImplAtomicType_*)in_pSrc );	\
+		AK_ATOMIC_MSVC_BARRIER( in_eOrder );																								\
+		return value;																														\
+	}																																		\
+	AkForceInline void AkAtomicStore##_Suffix_( volatile _AtomicType_ * io_pDest, _ValueType_ in_value, AkMemoryOrder in_eOrder = AkMemoryOrder_SeqCst ) \
+	{																																		\
+		if ( in_eOrder == AkMemoryOrder_SeqCst )																							\
+			AkAtomicMsvc<_ImplAtomicType_, _ImplValueType_>::Exchange( (volatile _ImplAtomicType_*)io_pDest, (_ImplValueType_)in_value );	\
+		else																																\
+		{																																	\
+			AK_ATOMIC_MSVC_BARRIER( in_eOrder );																							\
+			AkAtomicMsvc<_ImplAtomicType_, _ImplValueType_>::Store( (volatile _ImplAtomicType_*)io_pDest, (_ImplValueType_)in_value );	\
+		}																																	\
+	}																																		\
+	AkForceInline _ValueType_ AkAtomicFetchAdd##_Suffix_( volatile _AtomicType_ * io_pDest, _ValueType_ in_value, AkMemoryOrder = AkMemoryOrder_SeqCst ) \
+	{																																		\
+		return (_ValueType_)AkAtomicMsvc<_ImplAtomicType_, _ImplValueType_>::FetchAdd( (volatile _ImplAtomicType_*)io_pDest, (_ImplValueType_)in_value ); \
+	}																																		\
+	AkForceInline _ValueType_ AkAtomicExchange##_Suffix_( volatile _AtomicType_ * io_pDest, _ValueType_ in_value, AkMemoryOrder = AkMemoryOrder_SeqCst ) \
+	{																																		\
+		return (_ValueType_)AkAtomicMsvc<_ImplAtomicType_, _ImplValueType_>::Exchange( (volatile _ImplAtomicType_*)io_pDest, (_ImplValueType_)in_value ); \
+	}																																		\
+	AkForceInline bool AkAtomicCompareExchange##_Suffix_( volatile _AtomicType_ * io_pDest, _ValueType_ & io_expected, _ValueType_ in_value, AkMemoryOrder = AkMemoryOrder_SeqCst ) \
+	{																																		\
+		_ValueType_ prev = (_ValueType_)AkAtomicMsvc<_ImplAtomicType_, _ImplValueType_>::CompareExchange( (volatile _ImplAtomicType_*)io_pDest, (_ImplValueType_)in_value, (_ImplValueType_)io_expected ); \
+		if ( prev == io_expected )																											\
+			return true;																													\
+		io_expected = prev;																													\
+		return false;																														\
+	}
+
+	AK_DEFINE_ATOMIC_OPS( 32, AkAtomic32, AkInt32, AkAtomic32, AkInt32 )
+	AK_DEFINE_ATOMIC_OPS( 64, AkAtomic64, AkInt64, AkAtomic64, AkInt64 )
+#ifdef AK_POINTER_64
+	AK_DEFINE_ATOMIC_OPS( Ptr, AkAtomicPtr, AkIntPtr, AkAtomic64, AkInt64 )
+#else
+	AK_DEFINE_ATOMIC_OPS( Ptr, AkAtomicPtr, AkIntPtr, AkAtomic32, AkInt32 )
+#endif
+
+	#undef AK_DEFINE_ATOMIC_OPS
+
+	/// Memory fence with the specified ordering.
+	AkForceInline void AkAtomicThreadFence( AkMemoryOrder in_eOrder = AkMemoryOrder_SeqCst )
+	{
+		if ( in_eOrder == AkMemoryOrder_SeqCst )
+			MemoryBarrier();
+		else
+			AK_ATOMIC_MSVC_BARRIER( in_eOrder );
+	}
+#else
+#error AkAtomic.h: Undefined compiler
+#endif
+}
+
+#endif // _AK_TOOLS_COMMON_AKATOMIC_H
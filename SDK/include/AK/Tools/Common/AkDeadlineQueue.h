@@ -0,0 +1,176 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkDeadlineQueue.h
+
+/// \file 
+/// Earliest-deadline-first priority queue, used by deferred Low-Level I/O hooks to order pending transfers 
+/// by the time at which their stream runs out of data (see AkIoHeuristics::fDeadline and AK_SCHEDULER_DEADLINE_FIRST). 
+/// Ties are broken by priority (highest first), then by insertion order.
+
+#ifndef _AK_TOOLS_COMMON_AKDEADLINEQUEUE_H
+#define _AK_TOOLS_COMMON_AKDEADLINEQUEUE_H
+
+#include <AK/Tools/Common/AkArray.h>
+
+/// Binary min-heap of items keyed by deadline. T is copied by assignment.
+template <class T, class TAlloc = ArrayPoolDefault>
+class AkDeadlineQueue
+{
+public:
+	struct Entry
+	{
+		T			item;
+		AkReal64	fDeadline;		// Absolute time, in ms. Double precision, so that clocks with a large epoch keep sub-ms resolution.
+		AkPriority	priority;
+		AkUInt32	uSequence;		// Insertion order, for FIFO among equal keys.
+	};
+
+	AkDeadlineQueue() : m_uNextSequence( 0 ) {}
+
+	AKRESULT Reserve( AkUInt32 in_uNumItems ) { return m_heap.Reserve( in_uNumItems ); }
+	void Term() { m_heap.Term(); }
+
+	bool IsEmpty() const { return m_heap.Length() == 0; }
+	AkUInt32 Length() const { return m_heap.Length(); }
+
+	/// Add an item. 
+	/// \return False if memory could not be allocated.
+	bool Push( const T & in_item, AkReal64 in_fDeadline, AkPriority in_priority = AK_DEFAULT_PRIORITY )
+	{
+		Entry * pEntry = m_heap.AddLast();
+		if ( !pEntry )
+			return false;
+		pEntry->item = in_item;
+		pEntry->fDeadline = in_fDeadline;
+		pEntry->priority = in_priority;
+		pEntry->uSequence = m_uNextSequence++;
+		SiftUp( m_heap.Length() - 1 );
+		return true;
+	}
+
+	/// Entry at a given index, in heap order (not sorted). Use with Remove() to scan the queue.
+	const Entry & operator[]( AkUInt32 in_uIndex ) const { return m_heap[ in_uIndex ]; }
+
+	/// Entry with the earliest deadline. The queue must not be empty.
+	const Entry & Top() const
+	{
+		AKASSERT( !IsEmpty() );
+		return m_heap[ 0 ];
+	}
+
+	/// Remove the entry with the earliest deadline.
+	T Pop()
+	{
+		AKASSERT( !IsEmpty() );
+		T item = m_heap[ 0 ].item;
+		RemoveAt( 0 );
+		return item;
+	}
+
+	/// Remove an item (e.g. a cancelled request). O(n).
+	/// \return False if the item was not found.
+	bool Remove( const T & in_item )
+	{
+		for ( AkUInt32 i = 0; i < m_heap.Length(); ++i )
+		{
+			if ( m_heap[ i ].item == in_item )
+			{
+				RemoveAt( i );
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	static bool Before( const Entry & in_a, const Entry & in_b )
+	{
+		if ( in_a.fDeadline != in_b.fDeadline )
+			return in_a.fDeadline < in_b.fDeadline;
+		if ( in_a.priority != in_b.priority )
+			return in_a.priority > in_b.priority;
+		return (AkInt32)( in_a.uSequence - in_b.uSequence ) < 0;
+	}
+
+	void RemoveAt( AkUInt32 in_uIndex )
+	{
+		AkUInt32 uLast = m_heap.Length() - 1;
+		if ( in_uIndex != uLast )
+		{
+			m_heap[ in_uIndex ] = m_heap[ uLast ];
+			m_heap.RemoveLast();
+			if ( in_uIndex > 0 && Before( m_heap[ in_uIndex ], m_heap[ ( in_uIndex - 1 ) / 2 ] ) )
+				SiftUp( in_uIndex );
+			else
+				SiftDown( in_uIndex );
+		}
+		else
+		{
+			m_heap.RemoveLast();
+		}
+	}
+
+	void SiftUp( AkUInt32 in_uIndex )
+	{
+		Entry entry = m_heap[ in_uIndex ];
+		while ( in_uIndex > 0 )
+		{
+			AkUInt32 uParent = ( in_uIndex - 1 ) / 2;
+			if ( !Before( entry, m_heap[ uParent ] ) )
+				break;
+			m_heap[ in_uIndex ] = m_heap[ uParent ];
+			in_uIndex = uParent;
+		}
+		m_heap[ in_uIndex ] = entry;
+	}
+
+	void SiftDown( AkUInt32 in_uIndex )
+	{
+		AkUInt32 uLength = m_heap.Length();
+		Entry entry = m_heap[ in_uIndex ];
+		for ( ;; )
+		{
+			AkUInt32 uChild = in_uIndex * 2 + 1;
+			if ( uChild >= uLength )
+				break;
+			if ( uChild + 1 < uLength && Before( m_heap[ uChild + 1 ], m_heap[ uChild ] ) )
+				++uChild;
+			if ( !Before( m_heap[ uChild ], entry ) )
+				break;
+			m_heap[ in_uIndex ] = m_heap[ uChild ];
+			in_uIndex = uChild;
+		}
+		m_heap[ in_uIndex ] = entry;
+	}
+
+	AkArray<Entry, const Entry &, TAlloc, AkGrowByGeometric>	m_heap;
+	AkUInt32												m_uNextSequence;
+};
+
+#endif // _AK_TOOLS_COMMON_AKDEADLINEQUEUE_H
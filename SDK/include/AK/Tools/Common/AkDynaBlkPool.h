@@ -29,12 +29,16 @@ the specific language governing permissions and limitations under the License.
 #define _AKBLOCKPOOL_H
 
 #include <AK/Tools/Common/AkObject.h>
+#include <AK/Tools/Common/AkArray.h> //For ArrayPoolDefault
 #include <AK/Tools/Common/AkAssert.h>
 #include <AK/Tools/Common/AkListBareLight.h>
+#include <AK/Tools/Common/AkLock.h>
+#include <AK/Tools/Common/AkAutoLock.h>
 
 //
 //  AkDynaBlkPool	- A dynamic block pool allocator which will grow (and shrink) in size in contiguous chunks of 'uPoolChunkSize' objects.
 //					- Fragmentation in the pool will prevent it from shrinking, but in many use cases this is acceptable.
+//					- Allocation is O(1). Free is O(1) when TAlloc is an AkDynaBlkPoolAlignedAllocator, O(number of chunks) otherwise.
 //
 
 #ifdef _DEBUG
@@ -64,10 +68,44 @@ the specific language governing permissions and limitations under the License.
 #define SCRUB_FREE_BLOCK(pObj)
 #endif
 
+// AkDynaBlkPoolAlignedAllocator
+//	Allocator policy for AkDynaBlkPool. Chunks are allocated on a uChunkAlignment boundary, which lets the pool find the chunk
+//	owning a block directly from the block's address in Free() instead of walking the chunk list.
+//	uChunkAlignment must be a power of two, at least sizeof(T)*uPoolChunkSize.
+template <class U_POOL, AkUInt32 uChunkAlignment>
+struct AkDynaBlkPoolAlignedAllocator
+{
+	AkForceInline void * Alloc( size_t in_uSize )
+	{
+		return AK::MemoryMgr::Malign( U_POOL::Get(), in_uSize, uChunkAlignment );
+	}
+
+	AkForceInline void Free( void * in_pAddress )
+	{
+		AK::MemoryMgr::Falign( U_POOL::Get(), in_pAddress );
+	}
+};
+
+// Chunk alignment guaranteed by an AkDynaBlkPool allocator policy. 0 means unknown: owner chunks are looked up linearly.
+template <class TAlloc>
+struct AkDynaBlkPoolChunkAlignment
+{
+	enum { Value = 0 };
+};
+
+template <class U_POOL, AkUInt32 uChunkAlignment>
+struct AkDynaBlkPoolChunkAlignment< AkDynaBlkPoolAlignedAllocator<U_POOL, uChunkAlignment> >
+{
+	enum { Value = uChunkAlignment };
+};
+
+template < typename T, AkUInt32 uPoolChunkSize, class TAlloc, class tLock, AkUInt32 uMagazineSize > class AkDynaBlkPoolShared;
+
 template  < typename T, AkUInt32 uPoolChunkSize, class TAlloc = ArrayPoolDefault>
 class AkDynaBlkPool: public TAlloc
 {
 	enum { kChunkMemoryBytes = sizeof(T)*uPoolChunkSize };
+	enum { kChunkAlignment = AkDynaBlkPoolChunkAlignment<TAlloc>::Value };
 
 	struct FreeBlock
 	{
@@ -78,7 +116,7 @@ class AkDynaBlkPool: public TAlloc
 
 	struct PoolChunk
 	{
-		PoolChunk() : pNextLightItem(NULL)
+		PoolChunk() : pNextLightItem(NULL), pPrevLightItem(NULL)
 		{
 			SCRUB_NEW_CHUNK();
 			for( AkUInt32 i=0; i<uPoolChunkSize; ++i )
@@ -92,11 +130,42 @@ class AkDynaBlkPool: public TAlloc
 		inline bool AllFree() const { return freeList.Length() == uPoolChunkSize; }
 		inline bool AllAllocd() const {	return freeList.IsEmpty();	}
 
-		AkUInt8 memory[ kChunkMemoryBytes ];
+		AkUInt8 memory[ kChunkMemoryBytes ];	// Must stay first: aligned chunks are found by masking block addresses.
 		PoolChunk* pNextLightItem;
+		PoolChunk* pPrevLightItem;
 		tFreeList freeList;
 	};
-	typedef AkListBareLight< PoolChunk > tChunkList;
+
+	// Doubly-linked so that chunks can move between the partial and full lists in constant time.
+	struct ChunkList
+	{
+		ChunkList() : pFirst(NULL) {}
+
+		inline void AddFirst( PoolChunk* in_pChunk )
+		{
+			in_pChunk->pPrevLightItem = NULL;
+			in_pChunk->pNextLightItem = pFirst;
+			if ( pFirst )
+				pFirst->pPrevLightItem = in_pChunk;
+			pFirst = in_pChunk;
+		}
+
+		inline void Remove( PoolChunk* in_pChunk )
+		{
+			if ( in_pChunk->pPrevLightItem )
+				in_pChunk->pPrevLightItem->pNextLightItem = in_pChunk->pNextLightItem;
+			else
+				pFirst = in_pChunk->pNextLightItem;
+
+			if ( in_pChunk->pNextLightItem )
+				in_pChunk->pNextLightItem->pPrevLightItem = in_pChunk->pPrevLightItem;
+
+			in_pChunk->pNextLightItem = NULL;
+			in_pChunk->pPrevLightItem = NULL;
+		}
+
+		PoolChunk* pFirst;
+	};
 
 public:
 
@@ -146,22 +215,25 @@ public:
 	}
 
 private:
+	template < typename, AkUInt32, class, class, AkUInt32 > friend class AkDynaBlkPoolShared;
+
 	T* Alloc()
 	{
 		FreeBlock* pItem = NULL;
-		PoolChunk* pChunk = NULL;
-		
-		pChunk = m_chunkList.First();
-		while (pChunk != NULL && pChunk->AllAllocd())
-			pChunk = pChunk->pNextLightItem;
+
+		// Chunks with at least one free block are kept apart, so the first one can always serve the allocation.
+		PoolChunk* pChunk = m_partialChunks.pFirst;
 
 		if (pChunk == NULL)
 		{
 			pChunk = (PoolChunk *) TAlloc::Alloc( sizeof( PoolChunk ) );
-			AkPlacementNew(pChunk) PoolChunk();
-			STATS_NEWCHUNK();
 			if (pChunk != NULL)
-				m_chunkList.AddFirst(pChunk);
+			{
+				AKASSERT( kChunkAlignment == 0 || ((AkUIntPtr)pChunk & (kChunkAlignment - 1)) == 0 );
+				AkPlacementNew(pChunk) PoolChunk();
+				STATS_NEWCHUNK();
+				m_partialChunks.AddFirst(pChunk);
+			}
 		}
 
 		if (pChunk != NULL)
@@ -171,6 +243,12 @@ private:
 			pChunk->freeList.RemoveFirst();
 			SCRUB_NEW_ALLOC(pItem);
 			STATS_ALLOC();
+
+			if (pChunk->AllAllocd())
+			{
+				m_partialChunks.Remove(pChunk);
+				m_fullChunks.AddFirst(pChunk);
+			}
 		}
 
 		return reinterpret_cast<T*>(pItem);
@@ -182,28 +260,52 @@ private:
 		
 		FreeBlock* pItem = reinterpret_cast<FreeBlock*>(pObj);
 
-		PoolChunk* pPrevChunk = NULL;
-		PoolChunk* pChunk = m_chunkList.First();
-		while (pChunk != NULL && !pChunk->BelongsTo(pItem))
+		PoolChunk* pChunk = FindChunk(pItem);
+		AKASSERT(pChunk != NULL && pChunk->BelongsTo(pItem));
+
+		if (pChunk->AllAllocd())
 		{
-			pPrevChunk = pChunk;
-			pChunk = pChunk->pNextLightItem;
+			m_fullChunks.Remove(pChunk);
+			m_partialChunks.AddFirst(pChunk);
 		}
 
-		AKASSERT(pChunk != NULL);
 		pChunk->freeList.AddFirst(pItem);
 		STATS_FREE();
 
 		if (pChunk->AllFree())
 		{
-			m_chunkList.RemoveItem(pChunk, pPrevChunk);
+			m_partialChunks.Remove(pChunk);
 			pChunk->~PoolChunk();
 			TAlloc::Free( pChunk );
 			STATS_DELCHUNK();
 		}
 	}
 
-	tChunkList m_chunkList;
+	inline PoolChunk* FindChunk( FreeBlock* in_pItem )
+	{
+		if ( kChunkAlignment != 0 )
+		{
+			AkStaticAssert< kChunkAlignment == 0 || ( (AkUInt32)kChunkAlignment >= (AkUInt32)kChunkMemoryBytes && ( kChunkAlignment & ( kChunkAlignment - 1 ) ) == 0 ) >::Assert();
+			return reinterpret_cast<PoolChunk*>( (AkUIntPtr)in_pItem & ~( (AkUIntPtr)kChunkAlignment - 1 ) );
+		}
+
+		// Blocks are more likely to be freed from full chunks in busy pools: look there first.
+		PoolChunk* pChunk = m_fullChunks.pFirst;
+		while (pChunk != NULL && !pChunk->BelongsTo(in_pItem))
+			pChunk = pChunk->pNextLightItem;
+
+		if (pChunk == NULL)
+		{
+			pChunk = m_partialChunks.pFirst;
+			while (pChunk != NULL && !pChunk->BelongsTo(in_pItem))
+				pChunk = pChunk->pNextLightItem;
+		}
+
+		return pChunk;
+	}
+
+	ChunkList m_partialChunks;	// Chunks with at least one free block.
+	ChunkList m_fullChunks;		// Chunks with all blocks allocated.
 
 #ifdef AK_DYNA_BLK_STATS
 	void Stats_Alloc()
@@ -232,5 +334,125 @@ public:
 #endif
 };
 
+//
+//  AkDynaBlkPoolShared	- An AkDynaBlkPool shared between threads, protected by tLock.
+//						- Each thread may own a Magazine: a small stack of free blocks that serves New()/Delete() without locking.
+//						  Magazines are refilled from, and spilled to, the shared pool by half their size at a time, under the lock.
+//						- Blocks may be deleted through any thread's magazine; they all return to the same pool.
+//						- Flush() must be called on each magazine before it is destroyed, or its blocks are leaked.
+//
+template < typename T, AkUInt32 uPoolChunkSize, class TAlloc = ArrayPoolDefault, class tLock = CAkLock, AkUInt32 uMagazineSize = 32 >
+class AkDynaBlkPoolShared
+{
+public:
+	class Magazine
+	{
+	public:
+		Magazine() : m_uNumBlocks(0) {}
+		~Magazine() { AKASSERT( m_uNumBlocks == 0 ); }
+
+		AkUInt32 Length() const { return m_uNumBlocks; }
+
+	private:
+		friend class AkDynaBlkPoolShared;
+
+		T* m_pBlocks[ uMagazineSize ];
+		AkUInt32 m_uNumBlocks;
+	};
+
+	T* New( Magazine& io_magazine )
+	{
+		T* ptr = Alloc( io_magazine );
+		if (ptr) AkPlacementNew(ptr) T;
+		return ptr;
+	}
+
+	template<typename A1>
+	T* New( Magazine& io_magazine, A1 a1 )
+	{
+		T* ptr = Alloc( io_magazine );
+		if (ptr) AkPlacementNew(ptr) T(a1);
+		return ptr;
+	}
+
+	template<typename A1, typename A2>
+	T* New( Magazine& io_magazine, A1 a1, A2 a2 )
+	{
+		T* ptr = Alloc( io_magazine );
+		if (ptr) AkPlacementNew(ptr) T(a1, a2);
+		return ptr;
+	}
+
+	template<typename A1, typename A2, typename A3>
+	T* New( Magazine& io_magazine, A1 a1, A2 a2, A3 a3 )
+	{
+		T* ptr = Alloc( io_magazine );
+		if (ptr) AkPlacementNew(ptr) T(a1, a2, a3);
+		return ptr;
+	}
+
+	template<typename A1, typename A2, typename A3, typename A4>
+	T* New( Magazine& io_magazine, A1 a1, A2 a2, A3 a3, A4 a4 )
+	{
+		T* ptr = Alloc( io_magazine );
+		if (ptr) AkPlacementNew(ptr) T(a1, a2, a3, a4);
+		return ptr;
+	}
+
+	void Delete( Magazine& io_magazine, T* ptr )
+	{
+		ptr->~T();
+		Free( io_magazine, ptr );
+	}
+
+	// Return all blocks cached in io_magazine to the shared pool.
+	void Flush( Magazine& io_magazine )
+	{
+		if ( io_magazine.m_uNumBlocks > 0 )
+		{
+			AkAutoLock<tLock> lock( m_lock );
+			while ( io_magazine.m_uNumBlocks > 0 )
+				m_pool.Free( io_magazine.m_pBlocks[ --io_magazine.m_uNumBlocks ] );
+		}
+	}
+
+private:
+	enum { kBatchSize = ( uMagazineSize / 2 ) > 0 ? ( uMagazineSize / 2 ) : 1 };
+
+	T* Alloc( Magazine& io_magazine )
+	{
+		if ( io_magazine.m_uNumBlocks == 0 )
+		{
+			AkAutoLock<tLock> lock( m_lock );
+			while ( io_magazine.m_uNumBlocks < (AkUInt32)kBatchSize )
+			{
+				T* pBlock = m_pool.Alloc();
+				if ( pBlock == NULL )
+					break;
+				io_magazine.m_pBlocks[ io_magazine.m_uNumBlocks++ ] = pBlock;
+			}
+
+			if ( io_magazine.m_uNumBlocks == 0 )
+				return NULL;
+		}
+
+		return io_magazine.m_pBlocks[ --io_magazine.m_uNumBlocks ];
+	}
+
+	void Free( Magazine& io_magazine, T* in_pBlock )
+	{
+		if ( io_magazine.m_uNumBlocks == uMagazineSize )
+		{
+			AkAutoLock<tLock> lock( m_lock );
+			for ( AkUInt32 i = 0; i < (AkUInt32)kBatchSize; ++i )
+				m_pool.Free( io_magazine.m_pBlocks[ --io_magazine.m_uNumBlocks ] );
+		}
+
+		io_magazine.m_pBlocks[ io_magazine.m_uNumBlocks++ ] = in_pBlock;
+	}
+
+	AkDynaBlkPool<T, uPoolChunkSize, TAlloc> m_pool;
+	tLock m_lock;
+};
 
 #endif
@@ -28,6 +28,10 @@ the specific language governing permissions and limitations under the License.
 #ifndef _FNVHASH_H
 #define _FNVHASH_H
 
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#endif
+
 // http://www.isthe.com/chongo/tech/comp/fnv/
 
 //////////////////////////////////////////////////////////////////
@@ -131,6 +135,124 @@ namespace AK
 	typedef FNVHash<Hash30> FNVHash30;
 	typedef FNVHash<Hash64> FNVHash64;
 
+	//////////////////////////////////////////////////////////////////
+	// Compile-time hashing of string literals.
+	// Results are identical to FNVHash32/FNVHash30::Compute() on the same characters, without the terminating null.
+	//////////////////////////////////////////////////////////////////
+
+#if (defined(__cplusplus) && __cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1900)
+	#define AK_FNV_CONSTEXPR constexpr
+	#define AK_FNV_HAS_CONSTEXPR
+#else
+	#define AK_FNV_CONSTEXPR inline
+#endif
+
+	namespace FNVConst
+	{
+		static const unsigned int k_uPrime32 = 16777619U;
+		static const unsigned int k_uOffsetBasis32 = 2166136261U;
+
+		// Single-expression helpers, so that they are valid C++11 constexpr functions.
+		AK_FNV_CONSTEXPR unsigned int ToLower( char in_c )
+		{
+			return ( in_c >= 'A' && in_c <= 'Z' ) ? (unsigned int)(unsigned char)( in_c + ( 'a' - 'A' ) ) : (unsigned int)(unsigned char)in_c;
+		}
+
+		AK_FNV_CONSTEXPR unsigned int Hash32( const char* in_psz, unsigned int in_uHash )
+		{
+			return *in_psz ? Hash32( in_psz + 1, ( in_uHash * k_uPrime32 ) ^ (unsigned int)(unsigned char)*in_psz ) : in_uHash;
+		}
+
+		AK_FNV_CONSTEXPR unsigned int Hash32Lower( const char* in_psz, unsigned int in_uHash )
+		{
+			return *in_psz ? Hash32Lower( in_psz + 1, ( in_uHash * k_uPrime32 ) ^ ToLower( *in_psz ) ) : in_uHash;
+		}
+
+		AK_FNV_CONSTEXPR unsigned int Fold30( unsigned int in_uHash )
+		{
+			return ( in_uHash >> 30 ) ^ ( in_uHash & 0x3FFFFFFF );
+		}
+	}
+
+	/// FNV-1 32-bit hash of a null-terminated string, usable in constant expressions.
+	AK_FNV_CONSTEXPR unsigned int FNVHash32Const( const char* in_psz )
+	{
+		return FNVConst::Hash32( in_psz, FNVConst::k_uOffsetBasis32 );
+	}
+
+	/// FNV-1 30-bit (XOR-folded) hash of a null-terminated string, usable in constant expressions.
+	AK_FNV_CONSTEXPR unsigned int FNVHash30Const( const char* in_psz )
+	{
+		return FNVConst::Fold30( FNVConst::Hash32( in_psz, FNVConst::k_uOffsetBasis32 ) );
+	}
+
+	/// Short ID of a Wwise object name, usable in constant expressions.
+	/// Same result as AK::SoundEngine::GetIDFromString(): ASCII letters are lowered before hashing with FNVHash30.
+	/// \code
+	/// static const AkUniqueID PLAY_FOOTSTEP = AK::ShortIDFromString( "Play_Footstep" );
+	/// \endcode
+	AK_FNV_CONSTEXPR unsigned int ShortIDFromString( const char* in_psz )
+	{
+		return FNVConst::Fold30( FNVConst::Hash32Lower( in_psz, FNVConst::k_uOffsetBasis32 ) );
+	}
+
+	//////////////////////////////////////////////////////////////////
+	// Batched hashing of many strings.
+	// Short IDs of in_uNumStrings null-terminated strings, as returned by ShortIDFromString().
+	// With SSE2, four strings are hashed in parallel, one per SIMD lane.
+	//////////////////////////////////////////////////////////////////
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+	namespace FNVConst
+	{
+		// Low 32 bits of the lane-wise product (SSE2 has no _mm_mullo_epi32).
+		static inline __m128i MulLo32( __m128i in_a, __m128i in_b )
+		{
+			__m128i even = _mm_mul_epu32( in_a, in_b );
+			__m128i odd = _mm_mul_epu32( _mm_srli_si128( in_a, 4 ), _mm_srli_si128( in_b, 4 ) );
+			return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 2, 0 ) ), _mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+		}
+	}
+
+	inline void ShortIDsFromStrings( const char* const* in_ppszStrings, unsigned int in_uNumStrings, unsigned int* out_pIDs )
+	{
+		const __m128i vPrime = _mm_set1_epi32( (int)FNVConst::k_uPrime32 );
+		unsigned int uString = 0;
+		for ( ; uString + 4 <= in_uNumStrings; uString += 4 )
+		{
+			const char* p[4] = { in_ppszStrings[uString], in_ppszStrings[uString + 1], in_ppszStrings[uString + 2], in_ppszStrings[uString + 3] };
+			__m128i vHash = _mm_set1_epi32( (int)FNVConst::k_uOffsetBasis32 );
+			for (;;)
+			{
+				// Lanes whose string has ended keep their hash and read the terminator again.
+				int c0 = (int)FNVConst::ToLower( *p[0] ), c1 = (int)FNVConst::ToLower( *p[1] ), c2 = (int)FNVConst::ToLower( *p[2] ), c3 = (int)FNVConst::ToLower( *p[3] );
+				if ( ( c0 | c1 | c2 | c3 ) == 0 )
+					break;
+
+				__m128i vChars = _mm_set_epi32( c3, c2, c1, c0 );
+				__m128i vActive = _mm_cmpgt_epi32( vChars, _mm_setzero_si128() );
+				__m128i vNext = _mm_xor_si128( FNVConst::MulLo32( vHash, vPrime ), vChars );
+				vHash = _mm_or_si128( _mm_and_si128( vActive, vNext ), _mm_andnot_si128( vActive, vHash ) );
+
+				p[0] += ( c0 != 0 ); p[1] += ( c1 != 0 ); p[2] += ( c2 != 0 ); p[3] += ( c3 != 0 );
+			}
+
+			// XOR-fold to 30 bits.
+			__m128i vFolded = _mm_xor_si128( _mm_srli_epi32( vHash, 30 ), _mm_and_si128( vHash, _mm_set1_epi32( 0x3FFFFFFF ) ) );
+			_mm_storeu_si128( (__m128i*)( out_pIDs + uString ), vFolded );
+		}
+
+		for ( ; uString < in_uNumStrings; ++uString )
+			out_pIDs[uString] = ShortIDFromString( in_ppszStrings[uString] );
+	}
+#else
+	inline void ShortIDsFromStrings( const char* const* in_ppszStrings, unsigned int in_uNumStrings, unsigned int* out_pIDs )
+	{
+		for ( unsigned int uString = 0; uString < in_uNumStrings; ++uString )
+			out_pIDs[uString] = ShortIDFromString( in_ppszStrings[uString] );
+	}
+#endif
+
 }
 
 #endif
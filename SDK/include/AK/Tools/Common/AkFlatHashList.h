@@ -0,0 +1,485 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the
+"Apache License"); you may not use this file except in compliance with the
+Apache License. You may obtain a copy of the Apache License at
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+#ifndef _AKFLATHASHLIST_H
+#define _AKFLATHASHLIST_H
+
+#include <AK/Tools/Common/AkHashList.h> // for AkHash, AkHashType
+#include <AK/Tools/Common/AkKeyDef.h>	// for MapStruct
+#include <AK/Tools/Common/AkObject.h>
+#include <AK/Tools/Common/AkPlatformFuncs.h>
+
+#if defined(AK_CPU_X86) || defined(AK_CPU_X86_64)
+#include <emmintrin.h>
+#define AK_FLATHASH_SSE2
+#endif
+
+//
+// AkFlatHashList - Open addressing hash map with the same Set/Exists/Unset/Iterator surface as AkHashList.
+//
+//	- Key-item pairs are stored inline in one contiguous slot array, with a parallel array of one control byte per slot.
+//	- The capacity is always a power of two; slots are probed in aligned groups of 16 control bytes,
+//	  which are compared in a single SSE2 instruction on x86 (and with a scalar loop elsewhere).
+//	- Unlike AkHashList, items are moved when the table grows: pointers returned by Set() and Exists()
+//	  are only valid until the next insertion. Use AkHashList when stable item addresses are required.
+//	- Erasing does not move other items, so iterators remain valid across Erase().
+//	- Iterators have no pItem member: code written as it.pItem->Assoc must use (*it) or it.GetSlot() instead.
+//
+// NOTE: the same AkHash( T_KEY ) function as AkHashList is used; its result is scrambled internally, so identity hashes are fine.
+//
+
+namespace AkFlatHash
+{
+	enum
+	{
+		kGroupSize = 16,
+		kMinCapacity = kGroupSize
+	};
+
+	// Control byte values. Full slots store the low 7 bits of the hash (0x00-0x7F).
+	static const AkUInt8 kCtrlEmpty = 0x80;
+	static const AkUInt8 kCtrlDeleted = 0xFE;
+
+	AkForceInline bool IsFull( AkUInt8 in_ctrl ) { return ( in_ctrl & 0x80 ) == 0; }
+
+	// Final mix of MurmurHash3; spreads identity hashes of sequential IDs over all bits.
+	AkForceInline AkHashType Mix( AkHashType in_uHash )
+	{
+		in_uHash ^= in_uHash >> 16;
+		in_uHash *= 0x85ebca6bU;
+		in_uHash ^= in_uHash >> 13;
+		in_uHash *= 0xc2b2ae35U;
+		in_uHash ^= in_uHash >> 16;
+		return in_uHash;
+	}
+
+	AkForceInline AkUInt32 H1( AkHashType in_uHash ) { return in_uHash >> 7; }
+	AkForceInline AkUInt8 H2( AkHashType in_uHash ) { return (AkUInt8)( in_uHash & 0x7F ); }
+
+	/// A group of kGroupSize control bytes. Match functions return a bit mask with one bit per matching slot.
+	struct Group
+	{
+#ifdef AK_FLATHASH_SSE2
+		AkForceInline Group( const AkUInt8 * in_pCtrl ) : ctrl( _mm_loadu_si128( (const __m128i *)in_pCtrl ) ) {}
+
+		AkForceInline AkUInt32 Match( AkUInt8 in_h2 ) const
+		{
+			return (AkUInt32)_mm_movemask_epi8( _mm_cmpeq_epi8( ctrl, _mm_set1_epi8( (char)in_h2 ) ) );
+		}
+
+		AkForceInline AkUInt32 MatchEmpty() const
+		{
+			return (AkUInt32)_mm_movemask_epi8( _mm_cmpeq_epi8( ctrl, _mm_set1_epi8( (char)kCtrlEmpty ) ) );
+		}
+
+		// Empty and deleted are the only values with the sign bit set.
+		AkForceInline AkUInt32 MatchEmptyOrDeleted() const
+		{
+			return (AkUInt32)_mm_movemask_epi8( ctrl );
+		}
+
+		__m128i ctrl;
+#else
+		AkForceInline Group( const AkUInt8 * in_pCtrl ) : pCtrl( in_pCtrl ) {}
+
+		AkForceInline AkUInt32 Match( AkUInt8 in_h2 ) const
+		{
+			AkUInt32 uMask = 0;
+			for ( AkUInt32 i = 0; i < kGroupSize; ++i )
+				uMask |= ( pCtrl[i] == in_h2 ) ? ( 1U << i ) : 0;
+			return uMask;
+		}
+
+		AkForceInline AkUInt32 MatchEmpty() const
+		{
+			return Match( kCtrlEmpty );
+		}
+
+		AkForceInline AkUInt32 MatchEmptyOrDeleted() const
+		{
+			AkUInt32 uMask = 0;
+			for ( AkUInt32 i = 0; i < kGroupSize; ++i )
+				uMask |= ( pCtrl[i] & 0x80 ) ? ( 1U << i ) : 0;
+			return uMask;
+		}
+
+		const AkUInt8 * pCtrl;
+#endif
+	};
+}
+
+template < class T_KEY, class T_ITEM, typename T_ALLOC = ArrayPoolDefault, class TMovePolicy = AkAssignmentMovePolicy<T_ITEM> >
+class AkFlatHashList: public T_ALLOC
+{
+public:
+	typedef MapStruct<T_KEY, T_ITEM> Slot;
+	typedef AkFlatHashList<T_KEY, T_ITEM, T_ALLOC, TMovePolicy> tThis;
+
+	struct Iterator
+	{
+		tThis* pTable;
+		AkUInt32 uiSlot;
+
+		inline Iterator& operator++()
+		{
+			AKASSERT( pTable && uiSlot < pTable->m_uCapacity );
+			uiSlot = pTable->NextFull( uiSlot + 1 );
+			return *this;
+		}
+
+		inline MapStruct<T_KEY, T_ITEM>& operator*()
+		{
+			AKASSERT( pTable && uiSlot < pTable->m_uCapacity );
+			return pTable->m_pSlots[ uiSlot ];
+		}
+
+		// Equivalent of AkHashList::Iterator::pItem->Assoc; NULL at End().
+		inline MapStruct<T_KEY, T_ITEM>* GetSlot() const
+		{
+			return ( pTable && uiSlot < pTable->m_uCapacity ) ? &pTable->m_pSlots[ uiSlot ] : NULL;
+		}
+
+		bool operator !=( const Iterator& in_rOp ) const
+		{
+			return ( uiSlot != in_rOp.uiSlot );
+		}
+	};
+
+	// Erasing never relocates other slots, so the simple iterator can be used to erase while iterating.
+	// Kept for source compatibility with AkHashList.
+	typedef Iterator IteratorEx;
+
+	Iterator Begin()
+	{
+		Iterator returnedIt;
+		returnedIt.pTable = this;
+		returnedIt.uiSlot = NextFull( 0 );
+		return returnedIt;
+	}
+
+	inline IteratorEx BeginEx()
+	{
+		return Begin();
+	}
+
+	inline Iterator End()
+	{
+		Iterator returnedIt;
+		returnedIt.pTable = this;
+		returnedIt.uiSlot = m_uCapacity;
+		return returnedIt;
+	}
+
+	IteratorEx FindEx( T_KEY in_Key )
+	{
+		IteratorEx returnedIt;
+		returnedIt.pTable = this;
+		returnedIt.uiSlot = FindSlot( in_Key );
+		return returnedIt;
+	}
+
+	AkFlatHashList()
+		: m_pSlots( NULL )
+		, m_pCtrl( NULL )
+		, m_uCapacity( 0 )
+		, m_uiSize( 0 )
+		, m_uGrowthLeft( 0 )
+	{
+	}
+
+	~AkFlatHashList()
+	{
+		AKASSERT( m_uiSize == 0 );
+		Term();
+	}
+
+	void Term()
+	{
+		RemoveAll();
+		if ( m_pSlots )
+		{
+			T_ALLOC::Free( m_pSlots );
+			m_pSlots = NULL;
+			m_pCtrl = NULL;
+			m_uCapacity = 0;
+			m_uGrowthLeft = 0;
+		}
+	}
+
+	void RemoveAll()
+	{
+		for ( AkUInt32 i = 0; i < m_uCapacity; ++i )
+		{
+			if ( AkFlatHash::IsFull( m_pCtrl[i] ) )
+				m_pSlots[i].item.~T_ITEM();
+		}
+
+		if ( m_pCtrl )
+			AKPLATFORM::AkMemSet( m_pCtrl, AkFlatHash::kCtrlEmpty, m_uCapacity );
+
+		m_uiSize = 0;
+		m_uGrowthLeft = MaxLoad( m_uCapacity );
+	}
+
+	T_ITEM * Exists( T_KEY in_Key )
+	{
+		AkUInt32 uiSlot = FindSlot( in_Key );
+		return ( uiSlot != m_uCapacity ) ? &( m_pSlots[ uiSlot ].item ) : NULL;
+	}
+
+	T_ITEM * Set( T_KEY in_Key )
+	{
+		bool bWasAlreadyThere;
+		return Set( in_Key, bWasAlreadyThere );
+	}
+
+	T_ITEM * Set( T_KEY in_Key, bool& out_bWasAlreadyThere )
+	{
+		AkHashType uHash = AkFlatHash::Mix( AkHash( in_Key ) );
+
+		AkUInt32 uiSlot = FindSlot( in_Key, uHash );
+		if ( uiSlot != m_uCapacity )
+		{
+			out_bWasAlreadyThere = true;
+			return &( m_pSlots[ uiSlot ].item );
+		}
+
+		out_bWasAlreadyThere = false;
+
+		if ( !CheckSize() )
+			return NULL;
+
+		uiSlot = FindInsertSlot( uHash );
+		if ( m_pCtrl[ uiSlot ] == AkFlatHash::kCtrlEmpty )
+			--m_uGrowthLeft; // reusing a tombstone does not consume growth.
+
+		m_pCtrl[ uiSlot ] = AkFlatHash::H2( uHash );
+		m_pSlots[ uiSlot ].key = in_Key;
+		AkPlacementNew( &( m_pSlots[ uiSlot ].item ) ) T_ITEM;
+
+		++m_uiSize;
+
+		return &( m_pSlots[ uiSlot ].item );
+	}
+
+	void Unset( T_KEY in_Key )
+	{
+		AkUInt32 uiSlot = FindSlot( in_Key );
+		if ( uiSlot != m_uCapacity )
+			RemoveSlot( uiSlot );
+	}
+
+	IteratorEx Erase( const IteratorEx& in_rIter )
+	{
+		AKASSERT( in_rIter.uiSlot < m_uCapacity && AkFlatHash::IsFull( m_pCtrl[ in_rIter.uiSlot ] ) );
+
+		RemoveSlot( in_rIter.uiSlot );
+
+		IteratorEx returnedIt;
+		returnedIt.pTable = this;
+		returnedIt.uiSlot = NextFull( in_rIter.uiSlot + 1 );
+		return returnedIt;
+	}
+
+	AkUInt32 Length() const
+	{
+		return m_uiSize;
+	}
+
+	AKRESULT Reserve( AkUInt32 in_uNumberOfEntires )
+	{
+		if ( in_uNumberOfEntires > MaxLoad( m_uCapacity ) )
+			return Resize( in_uNumberOfEntires );
+
+		return AK_Success;
+	}
+
+	// Rehash into a table large enough to hold in_uExpectedNumberOfEntires without growing.
+	AKRESULT Resize( AkUInt32 in_uExpectedNumberOfEntires )
+	{
+		in_uExpectedNumberOfEntires = AkMax( in_uExpectedNumberOfEntires, m_uiSize );
+
+		AkUInt32 uNewCapacity = AkFlatHash::kMinCapacity;
+		while ( MaxLoad( uNewCapacity ) < in_uExpectedNumberOfEntires )
+		{
+			if ( uNewCapacity >= 0x80000000 )
+				return AK_Fail;
+			uNewCapacity <<= 1;
+		}
+
+		Slot * pOldSlots = m_pSlots;
+		AkUInt8 * pOldCtrl = m_pCtrl;
+		AkUInt32 uOldCapacity = m_uCapacity;
+
+		size_t uSlotsBytes = ( sizeof( Slot ) * uNewCapacity + 15 ) & ~( (size_t)15 );
+		Slot * pNewSlots = (Slot *)T_ALLOC::Alloc( uSlotsBytes + uNewCapacity );
+		if ( pNewSlots == NULL )
+			return AK_InsufficientMemory;
+
+		m_pSlots = pNewSlots;
+		m_pCtrl = (AkUInt8 *)pNewSlots + uSlotsBytes;
+		m_uCapacity = uNewCapacity;
+		m_uGrowthLeft = MaxLoad( uNewCapacity ) - m_uiSize;
+		AKPLATFORM::AkMemSet( m_pCtrl, AkFlatHash::kCtrlEmpty, uNewCapacity );
+
+		for ( AkUInt32 i = 0; i < uOldCapacity; ++i )
+		{
+			if ( AkFlatHash::IsFull( pOldCtrl[i] ) )
+			{
+				Slot & rOld = pOldSlots[i];
+				AkHashType uHash = AkFlatHash::Mix( AkHash( rOld.key ) );
+				AkUInt32 uiSlot = FindInsertSlot( uHash );
+
+				m_pCtrl[ uiSlot ] = AkFlatHash::H2( uHash );
+				m_pSlots[ uiSlot ].key = rOld.key;
+				AkPlacementNew( &( m_pSlots[ uiSlot ].item ) ) T_ITEM;
+				TMovePolicy::Move( m_pSlots[ uiSlot ].item, rOld.item );
+				rOld.item.~T_ITEM();
+			}
+		}
+
+		if ( pOldSlots )
+			T_ALLOC::Free( pOldSlots );
+
+		return AK_Success;
+	}
+
+	// Number of slots (power of two).
+	inline AkUInt32 HashSize() const
+	{
+		return m_uCapacity;
+	}
+
+	inline bool CheckSize()
+	{
+		if ( m_uGrowthLeft == 0 )
+		{
+			// Mostly tombstones: rehash in place. Otherwise double.
+			AkUInt32 uTarget = ( m_uiSize < MaxLoad( m_uCapacity ) / 2 ) ? MaxLoad( m_uCapacity ) : MaxLoad( m_uCapacity ) + 1;
+			Resize( uTarget );
+		}
+
+		return ( m_uGrowthLeft > 0 );
+	}
+
+protected:
+
+	// Max load factor of 7/8.
+	static AkForceInline AkUInt32 MaxLoad( AkUInt32 in_uCapacity )
+	{
+		return in_uCapacity - ( in_uCapacity >> 3 );
+	}
+
+	AkForceInline AkUInt32 FindSlot( T_KEY in_Key ) const
+	{
+		return FindSlot( in_Key, AkFlatHash::Mix( AkHash( in_Key ) ) );
+	}
+
+	// Returns the slot index of in_Key, or m_uCapacity if not found.
+	AkUInt32 FindSlot( T_KEY in_Key, AkHashType in_uHash ) const
+	{
+		if ( m_uCapacity == 0 )
+			return m_uCapacity;
+
+		const AkUInt32 uMask = m_uCapacity - 1;
+		const AkUInt8 h2 = AkFlatHash::H2( in_uHash );
+		AkUInt32 uGroup = ( AkFlatHash::H1( in_uHash ) & uMask ) & ~( (AkUInt32)AkFlatHash::kGroupSize - 1 );
+
+		for ( AkUInt32 uProbed = 0; uProbed < m_uCapacity; uProbed += AkFlatHash::kGroupSize )
+		{
+			AkFlatHash::Group group( m_pCtrl + uGroup );
+
+			AkUInt32 uMatch = group.Match( h2 );
+			while ( uMatch )
+			{
+				AkUInt32 uiSlot = uGroup + AK::GetLowestSetBit( uMatch );
+				if ( m_pSlots[ uiSlot ].key == in_Key )
+					return uiSlot; // found
+				uMatch &= uMatch - 1;
+			}
+
+			if ( group.MatchEmpty() )
+				break; // not found
+
+			uGroup = ( uGroup + AkFlatHash::kGroupSize ) & uMask;
+		}
+
+		return m_uCapacity;
+	}
+
+	// Returns the first empty or deleted slot along the probe sequence of in_uHash. Table must not be full.
+	AkUInt32 FindInsertSlot( AkHashType in_uHash ) const
+	{
+		AKASSERT( m_uCapacity > 0 );
+
+		const AkUInt32 uMask = m_uCapacity - 1;
+		AkUInt32 uGroup = ( AkFlatHash::H1( in_uHash ) & uMask ) & ~( (AkUInt32)AkFlatHash::kGroupSize - 1 );
+
+		for ( ;; )
+		{
+			AkUInt32 uFree = AkFlatHash::Group( m_pCtrl + uGroup ).MatchEmptyOrDeleted();
+			if ( uFree )
+				return uGroup + AK::GetLowestSetBit( uFree );
+
+			uGroup = ( uGroup + AkFlatHash::kGroupSize ) & uMask;
+		}
+	}
+
+	AkUInt32 NextFull( AkUInt32 in_uiSlot ) const
+	{
+		while ( in_uiSlot < m_uCapacity && !AkFlatHash::IsFull( m_pCtrl[ in_uiSlot ] ) )
+			++in_uiSlot;
+		return in_uiSlot;
+	}
+
+	void RemoveSlot( AkUInt32 in_uiSlot )
+	{
+		m_pSlots[ in_uiSlot ].item.~T_ITEM();
+
+		// If the group still has an empty slot, no probe sequence can have gone past it: the slot can be freed for good.
+		AkUInt32 uGroup = in_uiSlot & ~( (AkUInt32)AkFlatHash::kGroupSize - 1 );
+		if ( AkFlatHash::Group( m_pCtrl + uGroup ).MatchEmpty() )
+		{
+			m_pCtrl[ in_uiSlot ] = AkFlatHash::kCtrlEmpty;
+			++m_uGrowthLeft;
+		}
+		else
+		{
+			m_pCtrl[ in_uiSlot ] = AkFlatHash::kCtrlDeleted;
+		}
+
+		--m_uiSize;
+	}
+
+	Slot *		m_pSlots;		///< Key-item pairs, m_uCapacity entries.
+	AkUInt8 *	m_pCtrl;		///< One control byte per slot, allocated in the same block as m_pSlots.
+	AkUInt32	m_uCapacity;	///< Number of slots; 0 or a power of two >= kGroupSize.
+	AkUInt32	m_uiSize;		///< Number of full slots.
+	AkUInt32	m_uGrowthLeft;	///< Number of empty (not deleted) slots that may still be consumed before rehashing.
+};
+
+#endif // _AKFLATHASHLIST_H
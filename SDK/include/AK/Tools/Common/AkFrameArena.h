@@ -0,0 +1,199 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkFrameArena.h
+
+/// \file 
+/// Frame-scoped bump allocator, for temporary buffers that only live for one audio frame.
+/// Allocation is a single atomic add, with no lock, and there is nothing to free: the whole arena is reset 
+/// at the end of the frame. A plug-in, or any code with a per-frame entry point, owns its arena and calls Reset() once 
+/// per frame, after the last user of its memory (e.g. at the end of a plug-in's Execute()).
+
+#ifndef _AK_TOOLS_COMMON_AKFRAMEARENA_H
+#define _AK_TOOLS_COMMON_AKFRAMEARENA_H
+
+#include <AK/Tools/Common/AkArray.h>
+#include <AK/Tools/Common/AkAtomic.h>
+
+/// Alignment of the start of the arena. Allocations aligned on more than this are padded.
+#ifndef AK_FRAME_ARENA_BASE_ALIGNMENT
+#define AK_FRAME_ARENA_BASE_ALIGNMENT 64
+#endif
+
+/// Frame arena statistics, for sizing the arena passed to AkFrameArenaT::Init().
+/// \sa 
+/// - AkFrameArenaT::GetStats()
+struct AkFrameArenaStats
+{
+	AkUInt32	uCapacity;			///< Size of the arena, in bytes.
+	AkUInt32	uUsed;				///< Bytes allocated in the current frame, including alignment padding.
+	AkUInt32	uLastFrameUsed;		///< Bytes allocated in the last completed frame.
+	AkUInt32	uPeakUsed;			///< High-water mark: highest number of bytes allocated in one frame since initialization or the last reset of statistics.
+	AkUInt32	uNumFailedAllocs;	///< Number of allocations that did not fit in the arena. Callers must then fall back to another allocator.
+	AkUInt32	uNumFrames;			///< Number of frames (calls to AkFrameArena::Reset()).
+};
+
+/// Bump allocator reset once per frame.
+/// Alloc() may be called from several threads at once (e.g. jobs of a job system). Reset(), Init() and Term() must 
+/// not run concurrently with Alloc(). Memory is uninitialized, and must not be used after Reset().
+template <class TAlloc = ArrayPoolDefault>
+class AkFrameArenaT : public TAlloc
+{
+public:
+	AkFrameArenaT()
+		: m_pBuffer( NULL )
+		, m_pBase( NULL )
+		, m_uCapacity( 0 )
+		, m_iUsed( 0 )
+		, m_iNumFailedAllocs( 0 )
+		, m_uLastFrameUsed( 0 )
+		, m_uPeakUsed( 0 )
+		, m_uNumFrames( 0 )
+	{
+	}
+
+	~AkFrameArenaT()
+	{
+		AKASSERT( m_pBuffer == NULL );
+	}
+
+	/// Allocate the arena.
+	AKRESULT Init( AkUInt32 in_uCapacity )
+	{
+		AKASSERT( m_pBuffer == NULL );
+		if ( in_uCapacity == 0 || in_uCapacity > 0x7FFFFFFF )
+			return AK_InvalidParameter;
+
+		m_pBuffer = TAlloc::Alloc( in_uCapacity + AK_FRAME_ARENA_BASE_ALIGNMENT );
+		if ( m_pBuffer == NULL )
+			return AK_InsufficientMemory;
+
+		m_pBase = (AkUInt8*)( ( (AkUIntPtr)m_pBuffer + AK_FRAME_ARENA_BASE_ALIGNMENT - 1 ) & ~( (AkUIntPtr)AK_FRAME_ARENA_BASE_ALIGNMENT - 1 ) );
+		m_uCapacity = in_uCapacity;
+		m_iUsed = 0;
+		ResetStats();
+		return AK_Success;
+	}
+
+	/// Free the arena.
+	void Term()
+	{
+		if ( m_pBuffer )
+		{
+			TAlloc::Free( m_pBuffer );
+			m_pBuffer = NULL;
+		}
+		m_pBase = NULL;
+		m_uCapacity = 0;
+		m_iUsed = 0;
+	}
+
+	/// Allocate memory valid until the next Reset(). Thread-safe.
+	/// \return The aligned block, or NULL if the arena is exhausted.
+	void * Alloc( 
+		size_t in_uSize,							///< Size, in bytes
+		AkUInt32 in_uAlign = AK_SIMD_ALIGNMENT		///< Alignment: a power of two
+		)
+	{
+		AKASSERT( in_uAlign != 0 && ( in_uAlign & ( in_uAlign - 1 ) ) == 0 );
+
+		// Offsets are kept multiples of AK_SIMD_ALIGNMENT; larger alignments reserve the worst-case padding.
+		AkUInt32 uSize = (AkUInt32)( ( in_uSize + AK_SIMD_ALIGNMENT - 1 ) & ~( (size_t)AK_SIMD_ALIGNMENT - 1 ) );
+		if ( in_uAlign > AK_SIMD_ALIGNMENT )
+			uSize += in_uAlign - AK_SIMD_ALIGNMENT;
+
+		// Check first, so that failed allocations do not make the offset grow without bound.
+		if ( in_uSize > m_uCapacity || (AkUInt32)AKPLATFORM::AkAtomicLoad32( &m_iUsed, AkMemoryOrder_Relaxed ) + uSize > m_uCapacity )
+		{
+			AKPLATFORM::AkAtomicFetchAdd32( &m_iNumFailedAllocs, 1, AkMemoryOrder_Relaxed );
+			return NULL;
+		}
+
+		AkUInt32 uOffset = (AkUInt32)AKPLATFORM::AkAtomicFetchAdd32( &m_iUsed, (AkInt32)uSize, AkMemoryOrder_Relaxed );
+		if ( uOffset + uSize > m_uCapacity )
+		{
+			AKPLATFORM::AkAtomicFetchAdd32( &m_iNumFailedAllocs, 1, AkMemoryOrder_Relaxed );
+			return NULL;
+		}
+
+		AkUIntPtr uAddress = (AkUIntPtr)( m_pBase + uOffset );
+		return (void*)( ( uAddress + in_uAlign - 1 ) & ~( (AkUIntPtr)in_uAlign - 1 ) );
+	}
+
+	/// Release all allocations of the frame, and update the high-water mark.
+	void Reset()
+	{
+		AkUInt32 uUsed = GetUsed();
+		m_uLastFrameUsed = uUsed;
+		if ( uUsed > m_uPeakUsed )
+			m_uPeakUsed = uUsed;
+		++m_uNumFrames;
+		AKPLATFORM::AkAtomicStore32( &m_iUsed, 0, AkMemoryOrder_Relaxed );
+	}
+
+	/// Bytes allocated in the current frame.
+	AkUInt32 GetUsed() const
+	{
+		AkUInt32 uUsed = (AkUInt32)AKPLATFORM::AkAtomicLoad32( (volatile AkAtomic32*)&m_iUsed, AkMemoryOrder_Relaxed );
+		return ( uUsed < m_uCapacity ) ? uUsed : m_uCapacity;
+	}
+
+	AkUInt32 GetCapacity() const { return m_uCapacity; }
+
+	void GetStats( AkFrameArenaStats & out_stats ) const
+	{
+		out_stats.uCapacity = m_uCapacity;
+		out_stats.uUsed = GetUsed();
+		out_stats.uLastFrameUsed = m_uLastFrameUsed;
+		out_stats.uPeakUsed = m_uPeakUsed;
+		out_stats.uNumFailedAllocs = (AkUInt32)AKPLATFORM::AkAtomicLoad32( (volatile AkAtomic32*)&m_iNumFailedAllocs, AkMemoryOrder_Relaxed );
+		out_stats.uNumFrames = m_uNumFrames;
+	}
+
+	void ResetStats()
+	{
+		m_iNumFailedAllocs = 0;
+		m_uLastFrameUsed = 0;
+		m_uPeakUsed = 0;
+		m_uNumFrames = 0;
+	}
+
+private:
+	void *				m_pBuffer;			// Allocated block.
+	AkUInt8 *			m_pBase;			// Aligned start of the arena.
+	AkUInt32			m_uCapacity;
+	volatile AkAtomic32	m_iUsed;			// Bump offset. May exceed m_uCapacity after concurrent failed allocations.
+	volatile AkAtomic32	m_iNumFailedAllocs;
+	AkUInt32			m_uLastFrameUsed;
+	AkUInt32			m_uPeakUsed;
+	AkUInt32			m_uNumFrames;
+};
+
+typedef AkFrameArenaT<> AkFrameArena;
+
+#endif // _AK_TOOLS_COMMON_AKFRAMEARENA_H
@@ -31,6 +31,10 @@ Copyright (c) 2006-2018 Audiokinetic Inc.
 #include <AK/Tools/Common/AkArray.h>
 #include <AK/Tools/Common/AkKeyDef.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#endif
+
 // The Key list is simply a list that may be referenced using a key
 // NOTE : 
 template <class T_KEY, class T_ITEM, class U_POOL = ArrayPoolDefault, AkUInt32 TGrowBy = 1, class TMovePolicy = AkAssignmentMovePolicy<MapStruct<T_KEY, T_ITEM> > >
@@ -440,5 +444,247 @@ public:
 	}
 };
 
+/// Search policy of the key index of AkIndexedSortedKeyArray.
+/// LowerBound() returns the index of the first key of in_pKeys that is not lesser than in_key, or in_uLength if there is none.
+/// The generic version is a branchless binary search: the loop has no data-dependent branch to mispredict, and all loads are on the dense key array.
+template <class T_KEY, class TComparePolicy> struct AkKeyIndexSearch
+{
+	static AkForceInline AkUInt32 LowerBound(const void* in_pThis, const T_KEY* in_pKeys, AkUInt32 in_uLength, T_KEY in_key)
+	{
+		const T_KEY* pBase = in_pKeys;
+		AkUInt32 uLength = in_uLength;
+		while (uLength > 1)
+		{
+			AkUInt32 uHalf = uLength / 2;
+			T_KEY key = pBase[uHalf - 1];
+			pBase = TComparePolicy::Lesser(in_pThis, key, in_key) ? pBase + uHalf : pBase;
+			uLength -= uHalf;
+		}
+
+		AkUInt32 uIdx = (AkUInt32)(pBase - in_pKeys);
+		if (uLength == 1)
+		{
+			T_KEY key = *pBase;
+			uIdx += TComparePolicy::Lesser(in_pThis, key, in_key) ? 1 : 0;
+		}
+		return uIdx;
+	}
+};
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+/// 32-bit keys with the default comparison: the binary search stops on a window of AK_KEY_INDEX_SIMD_WINDOW keys (a few cache lines), 
+/// in which the keys lesser than in_key are counted with SIMD compares.
+#define AK_KEY_INDEX_SIMD_WINDOW 16
+
+template <bool bSigned> struct AkKeyIndexSearch32
+{
+	static AkForceInline AkUInt32 LowerBound(const AkUInt32* in_pKeys, AkUInt32 in_uLength, AkUInt32 in_key)
+	{
+		// Signed compares on unsigned keys are made correct by flipping the sign bit of both operands.
+		const AkUInt32 uBias = bSigned ? 0 : 0x80000000;
+
+		const AkUInt32* pBase = in_pKeys;
+		AkUInt32 uLength = in_uLength;
+		while (uLength > AK_KEY_INDEX_SIMD_WINDOW)
+		{
+			AkUInt32 uHalf = uLength / 2;
+			pBase = ((AkInt32)(pBase[uHalf - 1] ^ uBias) < (AkInt32)(in_key ^ uBias)) ? pBase + uHalf : pBase;
+			uLength -= uHalf;
+		}
+
+		const __m128i vBias = _mm_set1_epi32((int)uBias);
+		const __m128i vKey = _mm_xor_si128(_mm_set1_epi32((int)in_key), vBias);
+		AkUInt32 uNumLesser = 0;
+		AkUInt32 i = 0;
+		for (; i + 4 <= uLength; i += 4)
+		{
+			__m128i vKeys = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pBase + i)), vBias);
+			AkUInt32 uMask = (AkUInt32)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(vKeys, vKey)));
+			uNumLesser += AK::GetNumNonZeroBits(uMask);
+		}
+		for (; i < uLength; ++i)
+			uNumLesser += ((AkInt32)(pBase[i] ^ uBias) < (AkInt32)(in_key ^ uBias)) ? 1 : 0;
+
+		return (AkUInt32)(pBase - in_pKeys) + uNumLesser;
+	}
+};
+
+template <> struct AkKeyIndexSearch< AkUInt32, AkDefaultSortedKeyCompare<AkUInt32> >
+{
+	static AkForceInline AkUInt32 LowerBound(const void*, const AkUInt32* in_pKeys, AkUInt32 in_uLength, AkUInt32 in_key)
+	{
+		return AkKeyIndexSearch32<false>::LowerBound(in_pKeys, in_uLength, in_key);
+	}
+};
+
+template <> struct AkKeyIndexSearch< AkInt32, AkDefaultSortedKeyCompare<AkInt32> >
+{
+	static AkForceInline AkUInt32 LowerBound(const void*, const AkInt32* in_pKeys, AkUInt32 in_uLength, AkInt32 in_key)
+	{
+		return AkKeyIndexSearch32<true>::LowerBound((const AkUInt32*)in_pKeys, in_uLength, (AkUInt32)in_key);
+	}
+};
+#endif
+
+/// Array of items, sorted by key, with a search accelerator: a copy of the keys is kept in a separate contiguous array, 
+/// so that lookups only touch the dense key index instead of one cache line of the (possibly large) items per step.
+/// Lookups use AkKeyIndexSearch, which is branchless, and SIMD for 32-bit keys.
+/// Add(), AddNoSetKey(), Set() and Unset() keep the index in sync, at the cost of moving the keys along with the items.
+/// Prefer it to AkSortedKeyArray for large tables that are searched much more often than they are modified.
+/// BEWARE WHEN MODIFYING THE ARRAY USING BASE CLASS METHODS: call RebuildIndex() afterwards.
+template <class T_KEY, class T_ITEM, class U_POOL, class U_KEY = AkGetArrayKey< T_KEY, T_ITEM >, unsigned long TGrowBy = 1, class TMovePolicy = AkAssignmentMovePolicy<T_ITEM>, class TComparePolicy = AkDefaultSortedKeyCompare<T_KEY> >
+class AkIndexedSortedKeyArray : public AkSortedKeyArray< T_KEY, T_ITEM, U_POOL, U_KEY, TGrowBy, TMovePolicy, TComparePolicy >
+{
+	typedef AkSortedKeyArray< T_KEY, T_ITEM, U_POOL, U_KEY, TGrowBy, TMovePolicy, TComparePolicy > tBase;
+	typedef AkArray< T_KEY, T_KEY, U_POOL, TGrowBy > tKeyIndex;
+
+public:
+	void Term()
+	{
+		m_keys.Term();
+		tBase::Term();
+	}
+
+	void RemoveAll()
+	{
+		m_keys.RemoveAll();
+		tBase::RemoveAll();
+	}
+
+	AKRESULT Reserve(AkUInt32 in_ulReserve)
+	{
+		AKRESULT res = m_keys.Reserve(in_ulReserve);
+		if (res == AK_Success)
+			res = tBase::Reserve(in_ulReserve);
+		return res;
+	}
+
+	T_ITEM* Exists(T_KEY in_key) const
+	{
+		bool bFound;
+		T_ITEM * pItem = BinarySearch(in_key, bFound);
+		return bFound ? pItem : NULL;
+	}
+
+	// Add an item to the list (allowing duplicate keys)
+
+	T_ITEM * Add(T_KEY in_key)
+	{
+		T_ITEM * pItem = AddNoSetKey(in_key);
+
+		// Then set the key
+		if (pItem)
+			U_KEY::Get(*pItem) = in_key;
+
+		return pItem;
+	}
+
+	// Add an item to the list (allowing duplicate keys). The caller must set the key of the item to in_key.
+
+	T_ITEM * AddNoSetKey(T_KEY in_key)
+	{
+		return InsertAt(LowerBound(in_key), in_key);
+	}
+
+	// Set an item in the list (returning existing item if present)
+
+	T_ITEM * Set(T_KEY in_key)
+	{
+		bool bFound;
+		T_ITEM * pItem = BinarySearch(in_key, bFound);
+		if (!bFound)
+		{
+			pItem = InsertAt((AkUInt32)(pItem ? pItem - this->m_pItems : 0), in_key);
+			if (pItem)
+				U_KEY::Get(*pItem) = in_key;
+		}
+
+		return pItem;
+	}
+
+	bool Unset(T_KEY in_key)
+	{
+		bool bFound;
+		T_ITEM * pItem = BinarySearch(in_key, bFound);
+		if (bFound)
+		{
+			AkUInt32 uIdx = (AkUInt32)(pItem - this->m_pItems);
+			m_keys.Erase(uIdx);
+			tBase::Erase(uIdx);
+		}
+
+		return bFound;
+	}
+
+	// WARNING: Do not use on types that need constructors or destructor called on Item objects at each creation.
+	// Rebuilds the whole key index.
+
+	void Reorder(T_KEY in_OldKey, T_KEY in_NewKey, const T_ITEM & in_item)
+	{
+		tBase::Reorder(in_OldKey, in_NewKey, in_item);
+		RebuildIndex();
+	}
+
+	// WARNING: Do not use on types that need constructors or destructor called on Item objects at each creation.
+
+	void ReSortArray() //To be used when the < > operator changed meaning.
+	{
+		tBase::ReSortArray();
+		RebuildIndex();
+	}
+
+	/// Copy the keys of the items to the key index. Must be called after modifying the array or the keys of its items through other means than this class.
+	AKRESULT RebuildIndex()
+	{
+		m_keys.RemoveAll();
+		if (m_keys.Reserved() < this->Length() && !m_keys.GrowArray(this->Length() - m_keys.Reserved()))
+			return AK_InsufficientMemory;
+
+		for (AkUInt32 i = 0; i < this->Length(); ++i)
+			*m_keys.AddLast() = U_KEY::Get(this->m_pItems[i]);
+
+		return AK_Success;
+	}
+
+	T_ITEM * BinarySearch( T_KEY in_key, bool & out_bFound ) const
+	{
+		AkUInt32 uIdx = LowerBound(in_key);
+		if (uIdx < this->Length())
+		{
+			T_KEY key = m_keys[uIdx];
+			out_bFound = !this->Lesser(in_key, key);
+		}
+		else
+		{
+			out_bFound = false;
+		}
+
+		return this->m_pItems ? this->m_pItems + uIdx : NULL;
+	}
+
+protected:
+	AkForceInline AkUInt32 LowerBound(T_KEY in_key) const
+	{
+		AKASSERT(m_keys.Length() == this->Length());
+		return this->Length() ? AkKeyIndexSearch<T_KEY, TComparePolicy>::LowerBound((const void*)this, &m_keys[0], this->Length(), in_key) : 0;
+	}
+
+	T_ITEM * InsertAt(AkUInt32 in_uIdx, T_KEY in_key)
+	{
+		T_KEY * pKey = m_keys.Insert(in_uIdx);
+		if (!pKey)
+			return NULL;
+		*pKey = in_key;
+
+		T_ITEM * pItem = (in_uIdx < this->Length()) ? this->Insert(in_uIdx) : this->AddLast();
+		if (!pItem)
+			m_keys.Erase(in_uIdx);
+
+		return pItem;
+	}
+
+	tKeyIndex m_keys;
+};
+
 
 #endif //_KEYARRAY_H_
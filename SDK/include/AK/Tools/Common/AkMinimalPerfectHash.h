@@ -0,0 +1,230 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkMinimalPerfectHash.h
+
+/// \file 
+/// Minimal perfect hash of 64-bit keys ("hash, displace and compress"): n keys map to n distinct slots.
+/// Lookup costs two hashes and one read of a 32-bit bucket seed; the table of seeds takes about one byte per key.
+/// Keys that were not part of the set map to an arbitrary slot, so the slot's content must be compared with the key.
+
+#ifndef _AK_TOOLS_COMMON_AKMINIMALPERFECTHASH_H
+#define _AK_TOOLS_COMMON_AKMINIMALPERFECTHASH_H
+
+#include <AK/Tools/Common/AkArray.h>
+
+#define AK_MPH_KEYS_PER_BUCKET		(4)			///< Average number of keys per bucket. Larger values make the seed table smaller and the build slower.
+#define AK_MPH_MAX_SEED_ATTEMPTS	(1 << 20)	///< Seeds tried for a bucket before Build() gives up.
+
+namespace AK
+{
+	namespace MPH
+	{
+		/// Seeds with this bit set directly hold the slot of the bucket's single key.
+		static const AkUInt32 kDirectSlot = 0x80000000;
+
+		/// Number of buckets (seeds) for a set of keys.
+		inline AkUInt32 GetNumBuckets( AkUInt32 in_uNumKeys )
+		{
+			return in_uNumKeys / AK_MPH_KEYS_PER_BUCKET + 1;
+		}
+
+		/// 64-bit finalizer (MurmurHash3 fmix64) of a key and seed.
+		inline AkUInt64 Hash( AkUInt64 in_uKey, AkUInt32 in_uSeed )
+		{
+			AkUInt64 h = in_uKey ^ ( (AkUInt64)in_uSeed * 0x9E3779B97F4A7C15ULL );
+			h ^= h >> 33;
+			h *= 0xFF51AFD7ED558CCDULL;
+			h ^= h >> 33;
+			h *= 0xC4CEB9FE1A85EC53ULL;
+			h ^= h >> 33;
+			return h;
+		}
+
+		/// Maps a hash to [0, in_uRange) without a division.
+		inline AkUInt32 Reduce( AkUInt64 in_uHash, AkUInt32 in_uRange )
+		{
+			return (AkUInt32)( ( ( in_uHash >> 32 ) * in_uRange ) >> 32 );
+		}
+
+		inline AkUInt32 GetBucket( AkUInt64 in_uKey, AkUInt32 in_uNumBuckets )
+		{
+			return Reduce( Hash( in_uKey, 0 ), in_uNumBuckets );
+		}
+
+		/// Slot of a key, in [0, in_uNumKeys).
+		inline AkUInt32 Lookup( 
+			AkUInt64 in_uKey,				///< Key
+			const AkUInt32 * in_pSeeds,		///< Seeds returned by Build()
+			AkUInt32 in_uNumBuckets,		///< GetNumBuckets( in_uNumKeys )
+			AkUInt32 in_uNumKeys			///< Number of keys in the set
+			)
+		{
+			const AkUInt32 uSeed = in_pSeeds[ GetBucket( in_uKey, in_uNumBuckets ) ];
+			if ( uSeed & kDirectSlot )
+				return uSeed & ~kDirectSlot;
+			return Reduce( Hash( in_uKey, uSeed + 1 ), in_uNumKeys );
+		}
+
+		/// Work buffers of Build().
+		template <class TAlloc>
+		struct BuildContext
+		{
+			typedef AkArray<AkUInt32, AkUInt32, TAlloc> Indices;
+			typedef AkArray<AkUInt8, AkUInt8, TAlloc> Flags;
+
+			static AKRESULT Build( 
+				const AkUInt64 * in_pKeys, 
+				AkUInt32 in_uNumKeys, 
+				AkUInt32 * out_pSeeds, 
+				AkUInt32 * out_pSlots, 
+				Indices & bucketStart,		// Keys grouped by bucket: bucket b holds keysByBucket[bucketStart[b], bucketStart[b+1]).
+				Indices & keysByBucket, 
+				Indices & bucketsBySize, 
+				Indices & sizeStart, 
+				Flags & slotTaken
+				)
+			{
+				const AkUInt32 uNumBuckets = GetNumBuckets( in_uNumKeys );
+				if ( !bucketStart.Resize( uNumBuckets + 1 ) 
+					|| !keysByBucket.Resize( in_uNumKeys ) 
+					|| !bucketsBySize.Resize( uNumBuckets ) 
+					|| !slotTaken.Resize( in_uNumKeys ) )
+				{
+					return AK_InsufficientMemory;
+				}
+
+				// Counting sort of keys by bucket.
+				for ( AkUInt32 b = 0; b <= uNumBuckets; b++ )
+					bucketStart[b] = 0;
+				for ( AkUInt32 i = 0; i < in_uNumKeys; i++ )
+					bucketStart[ GetBucket( in_pKeys[i], uNumBuckets ) + 1 ]++;
+				AkUInt32 uMaxSize = 0;
+				for ( AkUInt32 b = 0; b < uNumBuckets; b++ )
+				{
+					uMaxSize = AkMax( uMaxSize, bucketStart[b + 1] );
+					bucketStart[b + 1] += bucketStart[b];
+				}
+				for ( AkUInt32 i = 0; i < in_uNumKeys; i++ )
+					out_pSlots[i] = bucketStart[ GetBucket( in_pKeys[i], uNumBuckets ) ]++;	// Temporarily, position in keysByBucket.
+				for ( AkUInt32 i = 0; i < in_uNumKeys; i++ )
+					keysByBucket[ out_pSlots[i] ] = i;
+				for ( AkUInt32 b = uNumBuckets; b > 0; b-- )
+					bucketStart[b] = bucketStart[b - 1];
+				bucketStart[0] = 0;
+
+				// Counting sort of buckets by decreasing size.
+				if ( !sizeStart.Resize( uMaxSize + 2 ) )
+					return AK_InsufficientMemory;
+				for ( AkUInt32 s = 0; s < uMaxSize + 2; s++ )
+					sizeStart[s] = 0;
+				for ( AkUInt32 b = 0; b < uNumBuckets; b++ )
+					sizeStart[ uMaxSize - ( bucketStart[b + 1] - bucketStart[b] ) + 1 ]++;
+				for ( AkUInt32 s = 0; s <= uMaxSize; s++ )
+					sizeStart[s + 1] += sizeStart[s];
+				for ( AkUInt32 b = 0; b < uNumBuckets; b++ )
+					bucketsBySize[ sizeStart[ uMaxSize - ( bucketStart[b + 1] - bucketStart[b] ) ]++ ] = b;
+
+				for ( AkUInt32 i = 0; i < in_uNumKeys; i++ )
+					slotTaken[i] = 0;
+
+				AkUInt32 uNextFree = 0;
+				for ( AkUInt32 i = 0; i < uNumBuckets; i++ )
+				{
+					const AkUInt32 b = bucketsBySize[i];
+					const AkUInt32 uFirst = bucketStart[b];
+					const AkUInt32 uSize = bucketStart[b + 1] - uFirst;
+					if ( uSize == 0 )
+					{
+						out_pSeeds[b] = 0;
+						continue;
+					}
+					if ( uSize == 1 )
+					{
+						while ( slotTaken[uNextFree] )
+							++uNextFree;
+						slotTaken[uNextFree] = 1;
+						out_pSlots[ keysByBucket[uFirst] ] = uNextFree;
+						out_pSeeds[b] = kDirectSlot | uNextFree;
+						continue;
+					}
+
+					AkUInt32 uSeed = 0;
+					for ( ; uSeed < AK_MPH_MAX_SEED_ATTEMPTS; uSeed++ )
+					{
+						AkUInt32 k = 0;
+						for ( ; k < uSize; k++ )
+						{
+							const AkUInt32 uKey = keysByBucket[uFirst + k];
+							const AkUInt32 uSlot = Reduce( Hash( in_pKeys[uKey], uSeed + 1 ), in_uNumKeys );
+							if ( slotTaken[uSlot] )
+								break;
+							slotTaken[uSlot] = 1;
+							out_pSlots[uKey] = uSlot;
+						}
+						if ( k == uSize )
+							break;
+						// Release the slots taken by this attempt.
+						while ( k > 0 )
+							slotTaken[ out_pSlots[ keysByBucket[uFirst + --k] ] ] = 0;
+					}
+					if ( uSeed == AK_MPH_MAX_SEED_ATTEMPTS )
+						return AK_Fail; // Duplicate keys always collide.
+					out_pSeeds[b] = uSeed;
+				}
+				return AK_Success;
+			}
+		};
+
+		/// Builds a minimal perfect hash of a set of distinct keys. Buckets are placed from the largest to the smallest, 
+		/// each with the first seed that sends all of its keys to free slots; single-key buckets take the remaining free slots directly.
+		/// Temporary memory (about 13 bytes per key) is allocated with TAlloc.
+		/// \return AK_Success, AK_InsufficientMemory, or AK_Fail if keys are duplicated.
+		template <class TAlloc>
+		AKRESULT Build( 
+			const AkUInt64 * in_pKeys,		///< Keys
+			AkUInt32 in_uNumKeys,			///< Number of keys, less than kDirectSlot
+			AkUInt32 * out_pSeeds,			///< Returned seeds, GetNumBuckets( in_uNumKeys ) of them
+			AkUInt32 * out_pSlots			///< Returned slot of each key, in_uNumKeys of them
+			)
+		{
+			AKASSERT( in_uNumKeys < kDirectSlot );
+			typename BuildContext<TAlloc>::Indices bucketStart, keysByBucket, bucketsBySize, sizeStart;
+			typename BuildContext<TAlloc>::Flags slotTaken;
+			AKRESULT eResult = BuildContext<TAlloc>::Build( in_pKeys, in_uNumKeys, out_pSeeds, out_pSlots, bucketStart, keysByBucket, bucketsBySize, sizeStart, slotTaken );
+			bucketStart.Term();
+			keysByBucket.Term();
+			bucketsBySize.Term();
+			sizeStart.Term();
+			slotTaken.Term();
+			return eResult;
+		}
+	}
+}
+
+#endif // _AK_TOOLS_COMMON_AKMINIMALPERFECTHASH_H
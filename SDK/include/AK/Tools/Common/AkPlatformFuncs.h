@@ -102,6 +102,24 @@ namespace AK
 		while( in_uWord ){ ++num; in_uWord &= in_uWord-1; }
 		return num;
 	}
+
+	/// Index of the lowest set bit.
+	/// \return Bit index (0-31). in_uWord must not be 0.
+	AkForceInline AkUInt32 GetLowestSetBit( AkUInt32 in_uWord )
+	{
+		AKASSERT( in_uWord != 0 );
+#if defined(_MSC_VER)
+		unsigned long uIndex;
+		_BitScanForward( &uIndex, in_uWord );
+		return (AkUInt32)uIndex;
+#elif defined(__GNUC__) || defined(__clang__)
+		return (AkUInt32)__builtin_ctz( in_uWord );
+#else
+		AkUInt32 uIndex = 0;
+		while( !( in_uWord & 1 ) ){ ++uIndex; in_uWord >>= 1; }
+		return uIndex;
+#endif
+	}
 }
 
 
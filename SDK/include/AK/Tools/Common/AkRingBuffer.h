@@ -0,0 +1,311 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkRingBuffer.h
+
+/// \file 
+/// Bounded lock-free ring buffers, for passing items between threads without locks nor allocations.
+/// - AkSPSCRingBuffer: one producer thread and one consumer thread (for example, game thread to audio thread).
+/// - AkMPMCRingBuffer: any number of producer and consumer threads.
+/// Items are copied by assignment; T must be default-constructible. Capacity is rounded up to a power of two.
+
+#ifndef _AK_TOOLS_COMMON_AKRINGBUFFER_H
+#define _AK_TOOLS_COMMON_AKRINGBUFFER_H
+
+#include <AK/Tools/Common/AkArray.h>
+#include <AK/Tools/Common/AkAtomic.h>
+
+#ifndef AK_RINGBUFFER_CACHE_LINE_SIZE
+#define AK_RINGBUFFER_CACHE_LINE_SIZE 64
+#endif
+
+// Rounds up to the next power of two (0 if it does not fit in 32 bits).
+static AkForceInline AkUInt32 AkRingBufferCapacity( AkUInt32 in_uCapacity )
+{
+	AkUInt32 uCapacity = 1;
+	while ( uCapacity < in_uCapacity && uCapacity != 0 )
+		uCapacity <<= 1;
+	return uCapacity;
+}
+
+/// Single-producer, single-consumer ring buffer.
+/// Push() must only be called from one thread at a time, and Pop() from one thread at a time.
+/// Each side reads the other side's index only when its cached copy says the buffer is full (or empty), 
+/// so in steady state the indices do not bounce between cores.
+template <class T, class TAlloc = ArrayPoolDefault>
+class AkSPSCRingBuffer : public TAlloc
+{
+public:
+	AkSPSCRingBuffer()
+		: m_pItems( NULL )
+		, m_uMask( 0 )
+		, m_iHead( 0 )
+		, m_uCachedTail( 0 )
+		, m_iTail( 0 )
+		, m_uCachedHead( 0 )
+	{
+	}
+
+	~AkSPSCRingBuffer()
+	{
+		AKASSERT( m_pItems == NULL );
+	}
+
+	/// Allocate the buffer. in_uCapacity is rounded up to a power of two.
+	AKRESULT Init( AkUInt32 in_uCapacity )
+	{
+		AKASSERT( m_pItems == NULL );
+		AkUInt32 uCapacity = AkRingBufferCapacity( in_uCapacity );
+		if ( uCapacity == 0 )
+			return AK_InvalidParameter;
+
+		m_pItems = (T*)TAlloc::Alloc( sizeof( T ) * uCapacity );
+		if ( m_pItems == NULL )
+			return AK_InsufficientMemory;
+
+		for ( AkUInt32 i = 0; i < uCapacity; ++i )
+			AkPlacementNew( m_pItems + i ) T;
+
+		m_uMask = uCapacity - 1;
+		m_iHead = m_iTail = 0;
+		m_uCachedHead = m_uCachedTail = 0;
+		return AK_Success;
+	}
+
+	/// Free the buffer. Must be called before destroying the object. No thread may be using the buffer.
+	void Term()
+	{
+		if ( m_pItems )
+		{
+			for ( AkUInt32 i = 0; i <= m_uMask; ++i )
+				m_pItems[ i ].~T();
+			TAlloc::Free( m_pItems );
+			m_pItems = NULL;
+		}
+		m_uMask = 0;
+	}
+
+	/// Producer: add an item. Returns false if the buffer is full.
+	bool Push( const T & in_item )
+	{
+		AkUInt32 uHead = (AkUInt32)AKPLATFORM::AkAtomicLoad32( &m_iHead, AkMemoryOrder_Relaxed );
+		if ( uHead - m_uCachedTail > m_uMask )
+		{
+			m_uCachedTail = (AkUInt32)AKPLATFORM::AkAtomicLoad32( &m_iTail, AkMemoryOrder_Acquire );
+			if ( uHead - m_uCachedTail > m_uMask )
+				return false;
+		}
+
+		m_pItems[ uHead & m_uMask ] = in_item;
+		AKPLATFORM::AkAtomicStore32( &m_iHead, (AkInt32)( uHead + 1 ), AkMemoryOrder_Release );
+		return true;
+	}
+
+	/// Consumer: remove the oldest item. Returns false if the buffer is empty.
+	bool Pop( T & out_item )
+	{
+		AkUInt32 uTail = (AkUInt32)AKPLATFORM::AkAtomicLoad32( &m_iTail, AkMemoryOrder_Relaxed );
+		if ( uTail == m_uCachedHead )
+		{
+			m_uCachedHead = (AkUInt32)AKPLATFORM::AkAtomicLoad32( &m_iHead, AkMemoryOrder_Acquire );
+			if ( uTail == m_uCachedHead )
+				return false;
+		}
+
+		out_item = m_pItems[ uTail & m_uMask ];
+		AKPLATFORM::AkAtomicStore32( &m_iTail, (AkInt32)( uTail + 1 ), AkMemoryOrder_Release );
+		return true;
+	}
+
+	/// Number of items in the buffer. Only a snapshot when called while the other side is active.
+	AkUInt32 Length() const
+	{
+		return (AkUInt32)AKPLATFORM::AkAtomicLoad32( (volatile AkAtomic32*)&m_iHead, AkMemoryOrder_Acquire ) 
+			- (AkUInt32)AKPLATFORM::AkAtomicLoad32( (volatile AkAtomic32*)&m_iTail, AkMemoryOrder_Acquire );
+	}
+
+	AkUInt32 Capacity() const { return m_pItems ? m_uMask + 1 : 0; }
+
+private:
+	T *			m_pItems;
+	AkUInt32	m_uMask;
+
+	// Producer side.
+	AkUInt8		m_pad0[ AK_RINGBUFFER_CACHE_LINE_SIZE ];
+	AkAtomic32	m_iHead;		// Next slot to write.
+	AkUInt32	m_uCachedTail;	// Last value of m_iTail seen by the producer.
+
+	// Consumer side.
+	AkUInt8		m_pad1[ AK_RINGBUFFER_CACHE_LINE_SIZE ];
+	AkAtomic32	m_iTail;		// Next slot to read.
+	AkUInt32	m_uCachedHead;	// Last value of m_iHead seen by the consumer.
+	AkUInt8		m_pad2[ AK_RINGBUFFER_CACHE_LINE_SIZE ];
+};
+
+/// Multi-producer, multi-consumer ring buffer (bounded queue of D. Vyukov).
+/// Each slot carries a sequence number telling whether it is ready to be written or read for a given turn around the ring, 
+/// so producers and consumers only contend on a compare-exchange of their own index.
+/// Push() and Pop() are lock-free, but not wait-free: a thread preempted between claiming and publishing a slot delays the consumers of that slot.
+template <class T, class TAlloc = ArrayPoolDefault>
+class AkMPMCRingBuffer : public TAlloc
+{
+public:
+	AkMPMCRingBuffer()
+		: m_pSlots( NULL )
+		, m_uMask( 0 )
+		, m_iEnqueuePos( 0 )
+		, m_iDequeuePos( 0 )
+	{
+	}
+
+	~AkMPMCRingBuffer()
+	{
+		AKASSERT( m_pSlots == NULL );
+	}
+
+	/// Allocate the buffer. in_uCapacity is rounded up to a power of two, and must be at least 2.
+	AKRESULT Init( AkUInt32 in_uCapacity )
+	{
+		AKASSERT( m_pSlots == NULL );
+		AkUInt32 uCapacity = AkRingBufferCapacity( in_uCapacity < 2 ? 2 : in_uCapacity );
+		if ( uCapacity == 0 )
+			return AK_InvalidParameter;
+
+		m_pSlots = (Slot*)TAlloc::Alloc( sizeof( Slot ) * uCapacity );
+		if ( m_pSlots == NULL )
+			return AK_InsufficientMemory;
+
+		for ( AkUInt32 i = 0; i < uCapacity; ++i )
+		{
+			AkPlacementNew( m_pSlots + i ) Slot;
+			m_pSlots[ i ].iSequence = (AkInt32)i;
+		}
+
+		m_uMask = uCapacity - 1;
+		m_iEnqueuePos = m_iDequeuePos = 0;
+		return AK_Success;
+	}
+
+	/// Free the buffer. Must be called before destroying the object. No thread may be using the buffer.
+	void Term()
+	{
+		if ( m_pSlots )
+		{
+			for ( AkUInt32 i = 0; i <= m_uMask; ++i )
+				m_pSlots[ i ].~Slot();
+			TAlloc::Free( m_pSlots );
+			m_pSlots = NULL;
+		}
+		m_uMask = 0;
+	}
+
+	/// Add an item. Returns false if the buffer is full.
+	bool Push( const T & in_item )
+	{
+		// Positions and sequences wrap around: compute in unsigned arithmetic, and only compare signed differences.
+		Slot * pSlot;
+		AkUInt32 uPos = (AkUInt32)AKPLATFORM::AkAtomicLoad32( &m_iEnqueuePos, AkMemoryOrder_Relaxed );
+		for (;;)
+		{
+			pSlot = m_pSlots + ( uPos & m_uMask );
+			AkInt32 iDiff = (AkInt32)( (AkUInt32)AKPLATFORM::AkAtomicLoad32( &pSlot->iSequence, AkMemoryOrder_Acquire ) - uPos );
+			if ( iDiff == 0 )
+			{
+				// Slot free for this turn: claim it.
+				AkInt32 iExpected = (AkInt32)uPos;
+				if ( AKPLATFORM::AkAtomicCompareExchange32( &m_iEnqueuePos, iExpected, (AkInt32)( uPos + 1 ), AkMemoryOrder_Relaxed ) )
+					break;
+				uPos = (AkUInt32)iExpected;
+			}
+			else if ( iDiff < 0 )
+			{
+				return false; // Full.
+			}
+			else
+			{
+				uPos = (AkUInt32)AKPLATFORM::AkAtomicLoad32( &m_iEnqueuePos, AkMemoryOrder_Relaxed );
+			}
+		}
+
+		pSlot->item = in_item;
+		AKPLATFORM::AkAtomicStore32( &pSlot->iSequence, (AkInt32)( uPos + 1 ), AkMemoryOrder_Release );
+		return true;
+	}
+
+	/// Remove the oldest item. Returns false if the buffer is empty.
+	bool Pop( T & out_item )
+	{
+		Slot * pSlot;
+		AkUInt32 uPos = (AkUInt32)AKPLATFORM::AkAtomicLoad32( &m_iDequeuePos, AkMemoryOrder_Relaxed );
+		for (;;)
+		{
+			pSlot = m_pSlots + ( uPos & m_uMask );
+			AkInt32 iDiff = (AkInt32)( (AkUInt32)AKPLATFORM::AkAtomicLoad32( &pSlot->iSequence, AkMemoryOrder_Acquire ) - ( uPos + 1 ) );
+			if ( iDiff == 0 )
+			{
+				// Slot published for this turn: claim it.
+				AkInt32 iExpected = (AkInt32)uPos;
+				if ( AKPLATFORM::AkAtomicCompareExchange32( &m_iDequeuePos, iExpected, (AkInt32)( uPos + 1 ), AkMemoryOrder_Relaxed ) )
+					break;
+				uPos = (AkUInt32)iExpected;
+			}
+			else if ( iDiff < 0 )
+			{
+				return false; // Empty.
+			}
+			else
+			{
+				uPos = (AkUInt32)AKPLATFORM::AkAtomicLoad32( &m_iDequeuePos, AkMemoryOrder_Relaxed );
+			}
+		}
+
+		out_item = pSlot->item;
+		AKPLATFORM::AkAtomicStore32( &pSlot->iSequence, (AkInt32)( uPos + m_uMask + 1 ), AkMemoryOrder_Release );
+		return true;
+	}
+
+	AkUInt32 Capacity() const { return m_pSlots ? m_uMask + 1 : 0; }
+
+private:
+	struct Slot
+	{
+		AkAtomic32	iSequence;
+		T			item;
+	};
+
+	Slot *		m_pSlots;
+	AkUInt32	m_uMask;
+
+	AkUInt8		m_pad0[ AK_RINGBUFFER_CACHE_LINE_SIZE ];
+	AkAtomic32	m_iEnqueuePos;
+	AkUInt8		m_pad1[ AK_RINGBUFFER_CACHE_LINE_SIZE ];
+	AkAtomic32	m_iDequeuePos;
+	AkUInt8		m_pad2[ AK_RINGBUFFER_CACHE_LINE_SIZE ];
+};
+
+#endif // _AK_TOOLS_COMMON_AKRINGBUFFER_H
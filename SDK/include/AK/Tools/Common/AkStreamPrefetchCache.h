@@ -0,0 +1,237 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkStreamPrefetchCache.h
+
+/// \file 
+/// Bookkeeping for a prefetch policy implemented by the game, which pins the first bytes of the files referenced by prepared events 
+/// in the stream cache (AK::IAkStreamMgr::PinFileInCache()) within a memory budget:
+/// which files are prefetched, how many prepared events reference them, and which ones to evict to stay within the budget.
+/// Files that are no longer referenced are evicted first, then those of lowest priority, then the least recently opened.
+
+#ifndef _AK_TOOLS_COMMON_AKSTREAMPREFETCHCACHE_H
+#define _AK_TOOLS_COMMON_AKSTREAMPREFETCHCACHE_H
+
+#include <AK/SoundEngine/Common/AkTypes.h>
+#include <AK/Tools/Common/AkHashList.h>
+
+/// Counters of an AkStreamPrefetchCache (see AkStreamPrefetchCache::GetStats()).
+/// Hits, misses and evictions are counted since the creation of the cache or the last call to AkStreamPrefetchCache::ResetStats().
+/// The hit rate is uNumHits / ( uNumHits + uNumMisses ).
+struct AkStreamPrefetchStats
+{
+	AkUInt32	uNumFiles;			///< Files currently prefetched
+	AkUInt32	uBytes;				///< Bytes currently prefetched
+	AkUInt32	uBudget;			///< Maximum number of prefetched bytes
+	AkUInt32	uNumHits;			///< Stream opens of a prefetched file
+	AkUInt32	uNumMisses;			///< Stream opens of a file referenced by a prepared event that was not prefetched (evicted, or beyond the budget)
+	AkUInt32	uNumEvictions;		///< Files unpinned to make room for others
+};
+
+/// Prefetched file set, bounded by a budget in bytes. Not thread-safe.
+/// \sa AK::IAkStreamMgr::PinFileInCache(), AK::IAkStreamMgr::UnpinFileInCache()
+template <class TAlloc = ArrayPoolDefault>
+class AkStreamPrefetchCache
+{
+public:
+	/// Called for each file to unpin.
+	typedef void ( *EvictFunc )( AkFileID in_fileID, void * in_pCookie );
+
+	AkStreamPrefetchCache()
+		: m_uTick( 0 )
+	{
+		ResetStats();
+		m_stats.uNumFiles = 0;
+		m_stats.uBytes = 0;
+		m_stats.uBudget = 0;
+	}
+
+	/// Releases the bookkeeping. Files are not unpinned.
+	void Term()
+	{
+		m_files.Term();
+		m_stats.uNumFiles = 0;
+		m_stats.uBytes = 0;
+	}
+
+	/// Sets the budget, evicting files if needed.
+	void SetBudget( AkUInt32 in_uBudget, EvictFunc in_pfnEvict, void * in_pCookie )
+	{
+		m_stats.uBudget = in_uBudget;
+		EvictUntil( 0, AK_MAX_PRIORITY + 1, in_pfnEvict, in_pCookie );
+	}
+
+	/// Adds a reference to a file from a prepared event, evicting other files if needed.
+	/// \return True if the caller must pin the file (it was not prefetched yet and fits in the budget).
+	bool AddRef( 
+		AkFileID in_fileID,				///< File ID
+		AkUInt32 in_uBytes,				///< Bytes to pin: prefetch size, at least the first buffer of the stream
+		AkPriority in_priority,			///< Caching priority
+		EvictFunc in_pfnEvict,			///< Unpins evicted files
+		void * in_pCookie				///< Passed to in_pfnEvict
+		)
+	{
+		Entry * pEntry = m_files.Exists( in_fileID );
+		if ( pEntry )
+		{
+			pEntry->uRefCount++;
+			pEntry->priority = AkMax( pEntry->priority, in_priority );
+			return false;
+		}
+
+		// Make room among files of lower priority (and unreferenced files) only. Check that they free enough space 
+		// before evicting any of them, so that a file that cannot be added does not cost others their place.
+		if ( in_uBytes > m_stats.uBudget 
+			|| m_stats.uBytes - GetEvictableBytes( in_priority ) > m_stats.uBudget - in_uBytes 
+			|| !EvictUntil( in_uBytes, in_priority, in_pfnEvict, in_pCookie ) )
+			return false;
+
+		pEntry = m_files.Set( in_fileID );
+		if ( !pEntry )
+			return false;
+		pEntry->uBytes = in_uBytes;
+		pEntry->uRefCount = 1;
+		pEntry->uLastUse = ++m_uTick;
+		pEntry->priority = in_priority;
+		m_stats.uNumFiles++;
+		m_stats.uBytes += in_uBytes;
+		return true;
+	}
+
+	/// Releases a reference from a prepared event. The file stays prefetched until its space is needed.
+	void Release( AkFileID in_fileID )
+	{
+		Entry * pEntry = m_files.Exists( in_fileID );
+		if ( pEntry && pEntry->uRefCount > 0 )
+			pEntry->uRefCount--;
+	}
+
+	/// Records a stream open.
+	/// \return True if the file is prefetched (hit).
+	bool OnOpen( 
+		AkFileID in_fileID,				///< File ID
+		bool in_bIsPrepared				///< True if the file is referenced by a prepared event: a miss is only counted for those
+		)
+	{
+		Entry * pEntry = m_files.Exists( in_fileID );
+		if ( pEntry )
+		{
+			pEntry->uLastUse = ++m_uTick;
+			m_stats.uNumHits++;
+			return true;
+		}
+		if ( in_bIsPrepared )
+			m_stats.uNumMisses++;
+		return false;
+	}
+
+	inline bool IsPrefetched( AkFileID in_fileID ) { return m_files.Exists( in_fileID ) != NULL; }
+
+	/// Current counters. Hits, misses and evictions accumulate until ResetStats().
+	inline const AkStreamPrefetchStats & GetStats() const { return m_stats; }
+
+	/// Resets the hit, miss and eviction counters.
+	void ResetStats()
+	{
+		m_stats.uNumHits = 0;
+		m_stats.uNumMisses = 0;
+		m_stats.uNumEvictions = 0;
+	}
+
+private:
+	struct Entry
+	{
+		AkUInt32	uBytes;
+		AkUInt32	uRefCount;		// Prepared events referencing the file.
+		AkUInt32	uLastUse;		// Tick of the last open.
+		AkPriority	priority;
+	};
+
+	typedef AkHashList<AkFileID, Entry, TAlloc> Files;
+
+	/// Bytes of the files that EvictUntil() may evict for a file of priority in_priority.
+	AkUInt32 GetEvictableBytes( AkInt32 in_priority )
+	{
+		AkUInt32 uBytes = 0;
+		for ( typename Files::Iterator it = m_files.Begin(); it != m_files.End(); ++it )
+		{
+			const Entry & entry = (*it).item;
+			if ( entry.uRefCount == 0 || entry.priority < in_priority )
+				uBytes += entry.uBytes;
+		}
+		return uBytes;
+	}
+
+	/// Evicts files until in_uBytes fit in the budget. Referenced files of priority in_priority or more are kept.
+	/// Evictions scan the whole set; they only occur when the budget is exceeded.
+	/// \return False if the space could not be freed.
+	bool EvictUntil( AkUInt32 in_uBytes, AkInt32 in_priority, EvictFunc in_pfnEvict, void * in_pCookie )
+	{
+		while ( m_stats.uBytes + in_uBytes > m_stats.uBudget )
+		{
+			typename Files::IteratorEx victim = m_files.BeginEx();
+			bool bFound = false;
+			for ( typename Files::IteratorEx it = m_files.BeginEx(); it != m_files.End(); ++it )
+			{
+				const Entry & entry = (*it).item;
+				if ( entry.uRefCount > 0 && entry.priority >= in_priority )
+					continue;
+				if ( !bFound || IsBetterVictim( entry, (*victim).item ) )
+				{
+					victim = it;
+					bFound = true;
+				}
+			}
+			if ( !bFound )
+				return false;
+
+			const AkFileID fileID = (*victim).key;
+			m_stats.uBytes -= (*victim).item.uBytes;
+			m_stats.uNumFiles--;
+			m_stats.uNumEvictions++;
+			m_files.Erase( victim );
+			in_pfnEvict( fileID, in_pCookie );
+		}
+		return true;
+	}
+
+	static inline bool IsBetterVictim( const Entry & in_a, const Entry & in_b )
+	{
+		if ( ( in_a.uRefCount == 0 ) != ( in_b.uRefCount == 0 ) )
+			return in_a.uRefCount == 0;
+		if ( in_a.priority != in_b.priority )
+			return in_a.priority < in_b.priority;
+		return (AkInt32)( in_a.uLastUse - in_b.uLastUse ) < 0;
+	}
+
+	Files					m_files;
+	AkStreamPrefetchStats	m_stats;
+	AkUInt32				m_uTick;
+};
+
+#endif // _AK_TOOLS_COMMON_AKSTREAMPREFETCHCACHE_H
@@ -0,0 +1,300 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkStreamTraceRecorder.h
+
+/// \file 
+/// Local recorder of Stream Manager activity, written in the Chrome trace event format (JSON), which can be opened
+/// in chrome://tracing or ui.perfetto.dev. It does not require the authoring tool, and is meant for headless servers and test machines.
+/// 
+/// The trace shows:
+/// - Per device (process "Devices"): low-level queue depth, memory used, and one async span per transfer, from the time 
+/// the Low-Level I/O receives it to its completion (when the I/O hook reports transfers, see OnTransferBegin()).
+/// - Per stream (process "Streams"): buffered, virtual (buffered + requested) and target buffering sizes, and a "Starved" 
+/// instant event when an active automatic stream has no buffered data.
+/// 
+/// Usage:
+/// - Open() after the Stream Manager and its devices are created.
+/// - Call Sample() once per audio frame, from a single thread (for example after AK::SoundEngine::RenderAudio()).
+/// - Optionally, let the I/O hook report transfers to OnTransferBegin() and OnTransferEnd() (e.g. with an IAkIoUringTransferListener that forwards 
+/// to the recorder, see CAkIoUringIOHook::SetTransferListener()).
+/// - Close() before terminating the Stream Manager.
+
+#ifndef _AK_TOOLS_COMMON_AKSTREAMTRACERECORDER_H
+#define _AK_TOOLS_COMMON_AKSTREAMTRACERECORDER_H
+
+#include <AK/SoundEngine/Common/IAkStreamMgr.h>
+#include <AK/Tools/Common/AkPlatformFuncs.h>
+#include <AK/Tools/Common/AkLock.h>
+#include <AK/Tools/Common/AkAutoLock.h>
+
+#include <stdio.h>
+
+#define AK_STREAM_TRACE_PID_DEVICES		(1)		///< Trace process of device tracks
+#define AK_STREAM_TRACE_PID_STREAMS		(2)		///< Trace process of stream tracks
+
+/// Writes Stream Manager activity to a Chrome trace file. Sample() and Open()/Close() must be called from the same thread;
+/// OnTransferBegin() and OnTransferEnd() may be called from any thread.
+class CAkStreamTraceRecorder
+{
+public:
+	CAkStreamTraceRecorder()
+		: m_pFile( NULL )
+		, m_pProfile( NULL )
+		, m_iStartTime( 0 )
+		, m_fTicksPerUs( 1.f )
+		, m_uNumEvents( 0 )
+	{
+	}
+
+	~CAkStreamTraceRecorder()
+	{
+		AKASSERT( !m_pFile || !"Close() was not called" );
+	}
+
+	/// Creates the trace file and starts monitoring the Stream Manager.
+	/// \return AK_Success, AK_Fail if the file could not be created or the Stream Manager has no profiling interface.
+	AKRESULT Open( 
+		const char * in_pszFilePath,							///< Path of the JSON file
+		AK::IAkStreamMgrProfile * in_pProfile = NULL			///< Profiling interface; NULL for AK::IAkStreamMgr::Get()->GetStreamMgrProfile()
+		)
+	{
+		AKASSERT( !m_pFile );
+		if ( !in_pProfile && AK::IAkStreamMgr::Get() )
+			in_pProfile = AK::IAkStreamMgr::Get()->GetStreamMgrProfile();
+		if ( !in_pProfile )
+			return AK_Fail;
+
+		FILE * pFile = fopen( in_pszFilePath, "w" );
+		if ( !pFile )
+			return AK_Fail;
+		if ( in_pProfile->StartMonitoring() != AK_Success )
+		{
+			fclose( pFile );
+			return AK_Fail;
+		}
+
+		AkInt64 iFreq;
+		AKPLATFORM::PerformanceFrequency( &iFreq );
+
+		AkAutoLock<CAkLock> lock( m_lock );
+		AKPLATFORM::PerformanceCounter( &m_iStartTime );
+		m_fTicksPerUs = (AkReal64)iFreq / 1000000.0;
+		m_pFile = pFile;
+		m_pProfile = in_pProfile;
+		m_uNumEvents = 0;
+		fputs( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", m_pFile );
+		WriteProcessName( AK_STREAM_TRACE_PID_DEVICES, "Devices" );
+		WriteProcessName( AK_STREAM_TRACE_PID_STREAMS, "Streams" );
+		return AK_Success;
+	}
+
+	/// Stops monitoring and completes the trace file.
+	/// \return AK_Success, or AK_Fail if the file could not be written.
+	AKRESULT Close()
+	{
+		if ( !m_pFile )
+			return AK_Success;
+		m_pProfile->StopMonitoring();
+
+		AkAutoLock<CAkLock> lock( m_lock );
+		fputs( "\n]}\n", m_pFile );
+		const bool bError = ferror( m_pFile ) != 0;
+		const bool bCloseError = fclose( m_pFile ) != 0;
+		m_pFile = NULL;
+		m_pProfile = NULL;
+		return ( bError || bCloseError ) ? AK_Fail : AK_Success;
+	}
+
+	inline bool IsOpen() const { return m_pFile != NULL; }
+
+	/// Number of events written since Open().
+	inline AkUInt32 GetNumEvents() const { return m_uNumEvents; }
+
+	/// Samples the state of all devices and streams.
+	void Sample()
+	{
+		if ( !m_pFile )
+			return;
+		const AkUInt64 uTime = GetTimeUs();
+
+		const AkUInt32 uNumDevices = m_pProfile->GetNumDevices();
+		for ( AkUInt32 uDevice = 0; uDevice < uNumDevices; uDevice++ )
+		{
+			AK::IAkDeviceProfile * pDevice = m_pProfile->GetDeviceProfile( uDevice );
+			if ( pDevice->IsNew() )
+			{
+				AkDeviceDesc desc;
+				pDevice->GetDesc( desc );
+				char szName[ AK_MONITOR_DEVICENAME_MAXLENGTH ];
+				ToAscii( desc.szDeviceName, desc.uStringSize, szName, sizeof( szName ) );
+				AkAutoLock<CAkLock> lock( m_lock );
+				WriteThreadName( AK_STREAM_TRACE_PID_DEVICES, desc.deviceID, szName );
+				pDevice->ClearNew();
+			}
+
+			AkDeviceData data;
+			pDevice->GetData( data );
+			{
+				AkAutoLock<CAkLock> lock( m_lock );
+				BeginEvent();
+				fprintf( m_pFile, "{\"name\":\"Device %u queue\",\"ph\":\"C\",\"ts\":%llu,\"pid\":%u,\"args\":{\"pending\":%u,\"completed\":%u,\"cancelled\":%u}}", 
+					data.deviceID, (unsigned long long)uTime, AK_STREAM_TRACE_PID_DEVICES, 
+					data.uNumLowLevelRequestsPending, data.uNumLowLevelRequestsCompleted, data.uNumLowLevelRequestsCancelled );
+				BeginEvent();
+				fprintf( m_pFile, "{\"name\":\"Device %u memory\",\"ph\":\"C\",\"ts\":%llu,\"pid\":%u,\"args\":{\"used\":%u,\"cached\":%u}}", 
+					data.deviceID, (unsigned long long)uTime, AK_STREAM_TRACE_PID_DEVICES, data.uMemUsed, data.uUnreferencedCachedBytes );
+			}
+
+			const AkUInt32 uNumStreams = pDevice->GetNumStreams();
+			for ( AkUInt32 uStream = 0; uStream < uNumStreams; uStream++ )
+				SampleStream( pDevice->GetStreamProfile( uStream ), uTime );
+		}
+	}
+
+	/// Records the start of a low-level transfer. in_pTransfer identifies the transfer until OnTransferEnd().
+	void OnTransferBegin( 
+		AkDeviceID in_deviceID,							///< Device of the transfer
+		const void * in_pTransfer,						///< Transfer (e.g. its AkAsyncIOTransferInfo)
+		AkUInt64 in_uFilePosition,						///< Position in the file, in bytes
+		AkUInt32 in_uSize,								///< Requested size, in bytes
+		AkPriority in_priority,							///< AkIoHeuristics::priority
+		AkReal32 in_fDeadline							///< AkIoHeuristics::fDeadline, in ms
+		)
+	{
+		AkAutoLock<CAkLock> lock( m_lock );
+		if ( !m_pFile )
+			return;
+		const AkUInt64 uTime = GetTimeUs();
+		BeginEvent();
+		fprintf( m_pFile, "{\"name\":\"Transfer\",\"cat\":\"io\",\"ph\":\"b\",\"id\":\"0x%llx\",\"ts\":%llu,\"pid\":%u,\"tid\":%u,\"args\":{\"position\":%llu,\"size\":%u,\"priority\":%d,\"deadline\":%.1f}}", 
+			(unsigned long long)(AkUIntPtr)in_pTransfer, (unsigned long long)uTime, AK_STREAM_TRACE_PID_DEVICES, in_deviceID, 
+			(unsigned long long)in_uFilePosition, in_uSize, (int)in_priority, in_fDeadline );
+	}
+
+	/// Records the end of a low-level transfer.
+	void OnTransferEnd( 
+		AkDeviceID in_deviceID,							///< Device of the transfer
+		const void * in_pTransfer,						///< Transfer passed to OnTransferBegin()
+		AKRESULT in_eResult								///< Result passed to the Stream Manager
+		)
+	{
+		AkAutoLock<CAkLock> lock( m_lock );
+		if ( !m_pFile )
+			return;
+		const AkUInt64 uTime = GetTimeUs();
+		BeginEvent();
+		fprintf( m_pFile, "{\"name\":\"Transfer\",\"cat\":\"io\",\"ph\":\"e\",\"id\":\"0x%llx\",\"ts\":%llu,\"pid\":%u,\"tid\":%u,\"args\":{\"result\":%d}}", 
+			(unsigned long long)(AkUIntPtr)in_pTransfer, (unsigned long long)uTime, AK_STREAM_TRACE_PID_DEVICES, in_deviceID, (int)in_eResult );
+	}
+
+	/// Flushes events written so far, so that a trace interrupted by a crash remains usable up to this point
+	/// (add the missing "]}" by hand; ui.perfetto.dev also accepts truncated files).
+	void Flush()
+	{
+		AkAutoLock<CAkLock> lock( m_lock );
+		if ( m_pFile )
+			fflush( m_pFile );
+	}
+
+private:
+	void SampleStream( AK::IAkStreamProfile * in_pStream, AkUInt64 in_uTime )
+	{
+		if ( in_pStream->IsNew() )
+		{
+			AkStreamRecord record;
+			in_pStream->GetStreamRecord( record );
+			char szName[ AK_MONITOR_STREAMNAME_MAXLENGTH ];
+			ToAscii( record.szStreamName, record.uStringSize, szName, sizeof( szName ) );
+			AkAutoLock<CAkLock> lock( m_lock );
+			WriteThreadName( AK_STREAM_TRACE_PID_STREAMS, record.uStreamID, szName );
+			in_pStream->ClearNew();
+		}
+
+		AkStreamData data;
+		in_pStream->GetStreamData( data );
+		AkAutoLock<CAkLock> lock( m_lock );
+		BeginEvent();
+		fprintf( m_pFile, "{\"name\":\"Stream %u\",\"ph\":\"C\",\"ts\":%llu,\"pid\":%u,\"tid\":%u,\"args\":{\"buffered\":%u,\"virtual\":%u,\"target\":%u}}", 
+			data.uStreamID, (unsigned long long)in_uTime, AK_STREAM_TRACE_PID_STREAMS, data.uStreamID, 
+			data.uBufferedSize, data.uVirtualBufferingSize, data.uTargetBufferingSize );
+		if ( data.bActive && data.uTargetBufferingSize > 0 && data.uBufferedSize == 0 )
+		{
+			BeginEvent();
+			fprintf( m_pFile, "{\"name\":\"Starved\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%llu,\"pid\":%u,\"tid\":%u,\"args\":{\"position\":%llu}}", 
+				(unsigned long long)in_uTime, AK_STREAM_TRACE_PID_STREAMS, data.uStreamID, (unsigned long long)data.uFilePosition );
+		}
+	}
+
+	inline AkUInt64 GetTimeUs() const
+	{
+		AkInt64 iNow;
+		AKPLATFORM::PerformanceCounter( &iNow );
+		return (AkUInt64)( (AkReal64)( iNow - m_iStartTime ) / m_fTicksPerUs );
+	}
+
+	// Writes the separator of the next event. m_lock must be held.
+	inline void BeginEvent()
+	{
+		if ( m_uNumEvents++ )
+			fputs( ",\n", m_pFile );
+	}
+
+	void WriteProcessName( AkUInt32 in_uPid, const char * in_pszName )
+	{
+		BeginEvent();
+		fprintf( m_pFile, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"%s\"}}", in_uPid, in_pszName );
+	}
+
+	void WriteThreadName( AkUInt32 in_uPid, AkUInt32 in_uTid, const char * in_pszName )
+	{
+		BeginEvent();
+		fprintf( m_pFile, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", in_uPid, in_uTid, in_pszName );
+	}
+
+	/// Converts a name for JSON: non-ASCII characters, quotes, backslashes and control characters become '?'.
+	static void ToAscii( const AkUtf16 * in_pszName, AkUInt32 in_uLength, char * out_pszName, AkUInt32 in_uMaxLength )
+	{
+		AkUInt32 uChar = 0;
+		for ( ; uChar < in_uLength && uChar < in_uMaxLength - 1 && in_pszName[uChar]; uChar++ )
+		{
+			const AkUtf16 c = in_pszName[uChar];
+			out_pszName[uChar] = ( c < 0x20 || c > 0x7E || c == '"' || c == '\\' ) ? '?' : (char)c;
+		}
+		out_pszName[uChar] = 0;
+	}
+
+	CAkLock						m_lock;			// Protects the file, from the sampling thread and I/O threads.
+	FILE *						m_pFile;
+	AK::IAkStreamMgrProfile *	m_pProfile;
+	AkInt64						m_iStartTime;
+	AkReal64					m_fTicksPerUs;
+	AkUInt32					m_uNumEvents;
+};
+
+#endif // _AK_TOOLS_COMMON_AKSTREAMTRACERECORDER_H
@@ -255,10 +255,22 @@ static AkForceInline AkUInt32 AkHash(const AkString<TAlloc, T_CHAR>& in_str)
 	return 0;
 }
 
+#ifndef AK_DBSTRING_NUM_SHARDS
+#define AK_DBSTRING_NUM_SHARDS 16			// Number of independently locked sub-tables of an AkDbString database.
+#endif
+
+#ifndef AK_DBSTRING_ARENA_BLOCK_SIZE
+#define AK_DBSTRING_ARENA_BLOCK_SIZE 4096	// Size, in bytes, of the blocks in which an AkDbString database stores its strings.
+#endif
+
 //
 // AkDbString - A string reference class that stores a hash to a string in a database.  If an identical string is found, the reference count in the database is incremented,
 //	so that we do not store duplicate strings.  Database can be made multi thread safe by passing in CAkLock for tLock, or AkNonThreaded if concurrent access is not needed.
 //
+//	The database is split in AK_DBSTRING_NUM_SHARDS shards selected by hash, each with its own table, lock and string arena, so that threads interning different 
+//	strings rarely contend. Only acquiring a string by value, and releasing its last reference, lock a shard: copying an AkDbString, releasing a reference that 
+//	is not the last one, and Get() are lock-free. Strings are packed in arena blocks of AK_DBSTRING_ARENA_BLOCK_SIZE bytes, which are freed when all their strings are released.
+//
 template<typename TAlloc, typename T_CHAR, typename tLock = AkNonThreaded>
 class AkDbString : public TAlloc
 {
@@ -266,20 +278,41 @@ public:
 	typedef AkDbString<TAlloc, T_CHAR, tLock> tThis;
 	typedef AkString<TAlloc, T_CHAR> tString;
 
+	struct ArenaBlock
+	{
+		ArenaBlock* pNextBlock;
+		AkUInt32 uSize;		// Capacity, in characters.
+		AkUInt32 uUsed;		// Characters handed out, live or not.
+		AkUInt32 uNumLive;	// Strings of this block still referenced.
+
+		T_CHAR* Data() { return (T_CHAR*)(this + 1); }
+	};
+
 	struct Entry
 	{
-		Entry() : refCount(0) {}
+		Entry() : pStr(NULL), pBlock(NULL), uHash(0), refCount(0) {}
 
-		tString str;
-		AkInt32 refCount;
+		const T_CHAR* pStr;
+		ArenaBlock* pBlock;
+		AkUInt32 uHash;
+		AkAtomic32 refCount;
 	};
 
 	typedef AkHashList<AkUInt32, Entry, TAlloc> tStringTable;
 
-	struct Instance : public TAlloc
+	struct Shard
 	{
+		Shard() : pBlocks(NULL) {}
+
 		tStringTable table;
 		tLock lock;
+		ArenaBlock* pBlocks;	// Current block first.
+		AkUInt8 pad[64];	// Keep the locks of neighboring shards on separate cache lines.
+	};
+
+	struct Instance : public TAlloc
+	{
+		Shard shards[AK_DBSTRING_NUM_SHARDS];
 	};
 
 public:
@@ -290,6 +323,8 @@ public:
 		if (pInstance == NULL)
 		{
 			pInstance = (Instance*)pInstance->TAlloc::Alloc(sizeof(Instance));
+			if (pInstance == NULL)
+				return AK_InsufficientMemory;
 			AkPlacementNew(pInstance) Instance();
 			return AK_Success;
 		}
@@ -302,32 +337,113 @@ public:
 	{
 		if (pInstance != NULL)
 		{
+			for (AkUInt32 i = 0; i < AK_DBSTRING_NUM_SHARDS; ++i)
+			{
+				Shard& shard = pInstance->shards[i];
+				shard.table.Term();
+				while (shard.pBlocks)
+				{
+					ArenaBlock* pNext = shard.pBlocks->pNextBlock;
+					pInstance->TAlloc::Free(shard.pBlocks);
+					shard.pBlocks = pNext;
+				}
+			}
 			pInstance->~Instance();
 			pInstance->TAlloc::Free(pInstance);
 			pInstance = NULL;
 		}
 	}
 
-	static void UnlockDB() { pInstance->lock.Unlock();}
-	static void LockDB() { pInstance->lock.Lock(); }
+	// Lock or unlock all shards, for callers that need the whole database to be stable.
+	static void UnlockDB() 
+	{
+		for (AkUInt32 i = AK_DBSTRING_NUM_SHARDS; i > 0; --i)
+			pInstance->shards[i - 1].lock.Unlock();
+	}
+	static void LockDB() 
+	{
+		for (AkUInt32 i = 0; i < AK_DBSTRING_NUM_SHARDS; ++i)
+			pInstance->shards[i].lock.Lock();
+	}
 
 private:
 
 	static Instance* pInstance;
 
+	static AkForceInline Shard& GetShard(AkUInt32 in_uHash)
+	{
+		// The table buckets use the low bits of the hash; select the shard with the high bits.
+		return pInstance->shards[(in_uHash >> 16) % AK_DBSTRING_NUM_SHARDS];
+	}
+
+	// Copy a string in the arena of a shard. Must be called with the shard locked.
+	static const T_CHAR* ArenaAlloc(Shard& in_shard, const T_CHAR* in_pStr, AkUInt32 in_uLen, ArenaBlock*& out_pBlock)
+	{
+		AkUInt32 uNumChars = in_uLen + 1;
+		ArenaBlock* pBlock = in_shard.pBlocks;
+		if (pBlock == NULL || pBlock->uSize - pBlock->uUsed < uNumChars)
+		{
+			AkUInt32 uSize = (AK_DBSTRING_ARENA_BLOCK_SIZE - sizeof(ArenaBlock)) / sizeof(T_CHAR);
+			if (uSize < uNumChars)
+				uSize = uNumChars;	// Dedicated block for long strings.
+
+			pBlock = (ArenaBlock*)pInstance->TAlloc::Alloc(sizeof(ArenaBlock) + uSize * sizeof(T_CHAR));
+			if (pBlock == NULL)
+				return NULL;
+
+			pBlock->pNextBlock = in_shard.pBlocks;
+			pBlock->uSize = uSize;
+			pBlock->uUsed = 0;
+			pBlock->uNumLive = 0;
+			in_shard.pBlocks = pBlock;
+		}
+
+		T_CHAR* pStr = pBlock->Data() + pBlock->uUsed;
+		if (in_uLen > 0)
+			AKPLATFORM::AkMemCpy(pStr, (void*)in_pStr, in_uLen * sizeof(T_CHAR));
+		pStr[in_uLen] = 0;
+		pBlock->uUsed += uNumChars;
+		pBlock->uNumLive++;
+
+		out_pBlock = pBlock;
+		return pStr;
+	}
+
+	// Release a string of the arena of a shard. Must be called with the shard locked.
+	static void ArenaFree(Shard& in_shard, ArenaBlock* in_pBlock)
+	{
+		AKASSERT(in_pBlock->uNumLive > 0);
+		if (--in_pBlock->uNumLive > 0)
+			return;
+
+		if (in_pBlock == in_shard.pBlocks)
+		{
+			// Current block: recycle it in place.
+			in_pBlock->uUsed = 0;
+			return;
+		}
+
+		ArenaBlock* pPrev = in_shard.pBlocks;
+		while (pPrev->pNextBlock != in_pBlock)
+			pPrev = pPrev->pNextBlock;
+		pPrev->pNextBlock = in_pBlock->pNextBlock;
+		pInstance->TAlloc::Free(in_pBlock);
+	}
+
 public:
-	AkDbString() : m_uHash(0)
+	AkDbString() : m_pEntry(NULL)
 	{}
 
-	AkDbString(const tThis& in_fromDbStr) : m_uHash(0) { Aquire(in_fromDbStr.m_uHash); }
+	AkDbString(const tThis& in_fromDbStr) : m_pEntry(NULL) { Aquire(in_fromDbStr.m_pEntry); }
 
 	// Construct from AkString
 	template<typename TAlloc2, typename T_CHAR2>
-	AkDbString(const AkString<TAlloc2, T_CHAR2>& in_fromStr) : m_uHash(0) { Aquire(in_fromStr); }
+	AkDbString(const AkString<TAlloc2, T_CHAR2>& in_fromStr) : m_pEntry(NULL) { Aquire(in_fromStr); }
 
 	tThis& operator=(const tThis& in_rhs)
 	{
-		Aquire(in_rhs.m_uHash);
+		if (&in_rhs != this)
+			Aquire(in_rhs.m_pEntry);
 		return *this;
 	}
 
@@ -344,15 +460,9 @@ public:
 		Release();
 	}
 
-	const T_CHAR* Get()
+	const T_CHAR* Get() const
 	{
-		if (m_uHash != 0)
-		{
-			Entry* pEntry = pInstance->table.Exists(m_uHash);
-			AKASSERT(pEntry != NULL);
-			return pEntry->str.Get();
-		}
-		return NULL;
+		return m_pEntry ? m_pEntry->pStr : NULL;
 	}
 
 protected:
@@ -366,88 +476,93 @@ protected:
 
 		if (in_str.Get() != NULL)
 		{
-			m_uHash = AkHash(in_str);
+			AkUInt32 uHash = AkHash(in_str);
 
-			LockDB();
+			// Convert outside of the lock, in case the character types differ.
+			tString str(in_str);
+			const T_CHAR* pStr = str.Get();
+			AkUInt32 uLen = pStr ? str.Length() : 0;
+
+			Shard& shard = GetShard(uHash);
+			shard.lock.Lock();
 			{
-				Entry* pEntry = pInstance->table.Set(m_uHash);
+				bool bWasAlreadyThere = false;
+				Entry* pEntry = shard.table.Set(uHash, bWasAlreadyThere);
 				if (pEntry != NULL)
 				{
-					pEntry->refCount++;
-
-					if (pEntry->str.Get() == NULL)
+					if (!bWasAlreadyThere)
 					{
-						pEntry->str = in_str;
-						pEntry->str.AllocCopy();
+						pEntry->pStr = ArenaAlloc(shard, pStr, uLen, pEntry->pBlock);
+						pEntry->uHash = uHash;
+					}
 
-						if (pEntry->str.Get() == NULL) // Allocation failure
-						{
-							pInstance->table.Unset(m_uHash);
-							m_uHash = 0;
-							res = AK_Fail;
-						}
+					if (pEntry->pStr != NULL)
+					{
+						// May revive an entry whose last reference is being released on another thread; see Release().
+						AKPLATFORM::AkInterlockedIncrement(&pEntry->refCount);
+						m_pEntry = pEntry;
+					}
+					else // Allocation failure
+					{
+						shard.table.Unset(uHash);
+						res = AK_Fail;
 					}
 				}
 				else
 				{
-					m_uHash = 0;
 					res = AK_Fail;
 				}
 			}
-			UnlockDB();
+			shard.lock.Unlock();
 		}
 
 		return res;
 	}
 
-	// in_uHash must have come from another AkDbString, and therefore already exist in the DB.
-	AKRESULT Aquire(AkUInt32 in_uHash)
+	// in_pEntry must have come from another AkDbString, which holds a reference: the entry cannot be erased concurrently, so no lock is needed.
+	AKRESULT Aquire(Entry* in_pEntry)
 	{
-		AKRESULT res = AK_Success;
+		if (in_pEntry != NULL)
+			AKPLATFORM::AkInterlockedIncrement(&in_pEntry->refCount);
 
 		Release();
 
-		if (in_uHash != 0)
-		{
-			m_uHash = in_uHash;
-			LockDB();
-			{
-				Entry* pEntry = pInstance->table.Exists(m_uHash);
-				AKASSERT(pEntry != NULL);
-
-				pEntry->refCount++;
-				AKASSERT(pEntry->str.Get() != NULL);
-			}
-			UnlockDB();
-		}
-
-		return res;
+		m_pEntry = in_pEntry;
+		return AK_Success;
 	}
 
 	void Release()
 	{
-		if (m_uHash != 0)
+		if (m_pEntry != NULL)
 		{
-			LockDB();
+			AkUInt32 uHash = m_pEntry->uHash;
+			if (AKPLATFORM::AkInterlockedDecrement(&m_pEntry->refCount) == 0)
 			{
-				tStringTable& table = pInstance->table;
-				typename tStringTable::IteratorEx it = table.FindEx(m_uHash);
-				Entry& entry = (*it).item;
-				AKASSERT(it != table.End() && entry.refCount > 0);
-
-				entry.refCount--;
-				if (entry.refCount == 0)
+				// Last reference. The entry may have been revived, or revived and erased, by other threads until the shard is locked: 
+				// look it up again rather than trusting m_pEntry.
+				Shard& shard = GetShard(uHash);
+				shard.lock.Lock();
 				{
-					table.Erase(it);
+					tStringTable& table = shard.table;
+					typename tStringTable::IteratorEx it = table.FindEx(uHash);
+					if (it != table.End())
+					{
+						Entry& entry = (*it).item;
+						if (AKPLATFORM::AkInterlockedCompareExchange(&entry.refCount, 0, 0)) // Still unreferenced
+						{
+							ArenaFree(shard, entry.pBlock);
+							table.Erase(it);
+						}
+					}
 				}
+				shard.lock.Unlock();
 			}
-			UnlockDB();
 
-			m_uHash = 0;
+			m_pEntry = NULL;
 		}
 	}
 
-	AkUInt32 m_uHash;
+	Entry* m_pEntry;
 
 };
 
@@ -0,0 +1,374 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided 
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+Apache License Usage
+
+Alternatively, this file may be used under the Apache License, Version 2.0 (the 
+"Apache License"); you may not use this file except in compliance with the 
+Apache License. You may obtain a copy of the Apache License at 
+http://www.apache.org/licenses/LICENSE-2.0.
+
+Unless required by applicable law or agreed to in writing, software distributed
+under the Apache License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES
+OR CONDITIONS OF ANY KIND, either express or implied. See the Apache License for
+the specific language governing permissions and limitations under the License.
+
+  Version: v2017.2.0  Build: 6500
+  Copyright (c) 2006-2018 Audiokinetic Inc.
+*******************************************************************************/
+
+
+// AkFutex.h
+
+/// \file 
+/// Adaptive spin-then-futex lock and event for Linux.
+/// - CAkFutexLock: recursive lock with the same interface as CAkLock. Spins briefly before sleeping in the kernel, 
+///   so that short critical sections shared by the game and audio threads are handed over without a context switch.
+/// - CAkFutexLockPI: same, with priority inheritance (FUTEX_LOCK_PI): a lower-priority owner is boosted while a 
+///   SCHED_FIFO thread, such as the audio thread, waits on the lock.
+/// - CAkFutexEvent: auto-reset event with the same semantics as AkEvent (each signal releases one wait).
+/// Define AK_FUTEX_STATS to collect contention statistics (see AkLockStats); they are available in Release builds.
+
+#pragma once
+
+#include <AK/Tools/Common/AkAtomic.h>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+#ifndef AK_FUTEX_MAX_SPIN_COUNT
+#define AK_FUTEX_MAX_SPIN_COUNT 200		///< Maximum number of spin iterations before sleeping in the kernel.
+#endif
+
+namespace AKPLATFORM
+{
+	/// Kernel thread ID of the calling thread, cached per thread.
+	inline AkInt32 AkFutexGetThreadID()
+	{
+		static __thread AkInt32 s_iThreadID = 0;
+		if ( s_iThreadID == 0 )
+			s_iThreadID = (AkInt32)syscall( SYS_gettid );
+		return s_iThreadID;
+	}
+
+	AkForceInline long AkFutex( volatile AkAtomic32 * in_pWord, int in_iOp, AkInt32 in_iValue, const struct timespec * in_pTimeout = NULL )
+	{
+		return syscall( SYS_futex, (AkAtomic32*)in_pWord, in_iOp, in_iValue, in_pTimeout, NULL, 0 );
+	}
+
+	/// Hint to the CPU that the thread is spinning.
+	AkForceInline void AkSpinPause()
+	{
+#if defined(__i386__) || defined(__x86_64__)
+		__builtin_ia32_pause();
+#elif defined(__arm__) || defined(__aarch64__)
+		__asm__ __volatile__( "yield" );
+#endif
+	}
+
+	AkForceInline AkUInt64 AkFutexNowUs()
+	{
+		struct timespec now;
+		clock_gettime( CLOCK_MONOTONIC, &now );
+		return (AkUInt64)now.tv_sec * 1000000 + (AkUInt64)now.tv_nsec / 1000;
+	}
+}
+
+/// Contention statistics of a CAkFutexLock or CAkFutexLockPI. Collected when AK_FUTEX_STATS is defined.
+struct AkLockStats
+{
+	AkUInt32	uNumAcquires;			///< Number of Lock() and successful TryLock() calls (recursive ones excluded).
+	AkUInt32	uNumContended;			///< Number of acquisitions that found the lock owned by another thread.
+	AkUInt32	uNumSleeps;				///< Number of contended acquisitions that had to sleep in the kernel after spinning.
+	AkUInt32	uNumSpins;				///< Total number of spin iterations.
+	AkUInt64	uWaitTimeUs;			///< Total time spent waiting for the lock, in microseconds.
+	AkUInt32	uMaxWaitTimeUs;			///< Longest wait for the lock, in microseconds.
+	AkInt32		iLastContendedOwner;	///< Kernel thread ID of the owner the last time the lock was contended.
+};
+
+//-----------------------------------------------------------------------------
+// CAkFutexLockBase class
+//	The lock word holds the kernel thread ID of the owner (0 when free), and FUTEX_WAITERS when threads sleep on it:
+//	the layout required by the priority-inheritance futex operations, also used by the plain version.
+//-----------------------------------------------------------------------------
+template< bool bPriorityInheritance >
+class CAkFutexLockBase
+{
+public:
+	/// Constructor
+	CAkFutexLockBase()
+		: m_iWord( 0 )
+		, m_uRecursion( 0 )
+		, m_iSpinEstimate( AK_FUTEX_MAX_SPIN_COUNT / 2 )
+	{
+#ifdef AK_FUTEX_STATS
+		ResetStats();
+#endif
+	}
+
+	/// Destructor
+	~CAkFutexLockBase()
+	{
+		AKASSERT( m_iWord == 0 );
+	}
+
+	/// Lock 
+	inline AKRESULT Lock( void )
+	{
+		AkInt32 iThreadID = AKPLATFORM::AkFutexGetThreadID();
+		if ( IsOwner( iThreadID ) )
+		{
+			++m_uRecursion;
+			return AK_Success;
+		}
+
+		AkInt32 iExpected = 0;
+		if ( !AKPLATFORM::AkAtomicCompareExchange32( &m_iWord, iExpected, iThreadID, AkMemoryOrder_Acquire ) )
+		{
+			if ( !LockContended( iThreadID, iExpected ) )
+				return AK_Fail;
+		}
+#ifdef AK_FUTEX_STATS
+		else
+		{
+			m_stats.uNumAcquires++;
+		}
+#endif
+
+		m_uRecursion = 1;
+		return AK_Success;
+	}
+
+	/// Unlock
+	inline AKRESULT Unlock( void )
+	{
+		AkInt32 iThreadID = AKPLATFORM::AkFutexGetThreadID();
+		if ( !IsOwner( iThreadID ) )
+			return AK_Fail;
+
+		if ( --m_uRecursion > 0 )
+			return AK_Success;
+
+		if ( bPriorityInheritance )
+		{
+			// Fast path when no thread sleeps on the lock; otherwise the kernel hands it to the highest priority waiter.
+			AkInt32 iExpected = iThreadID;
+			if ( !AKPLATFORM::AkAtomicCompareExchange32( &m_iWord, iExpected, 0, AkMemoryOrder_Release ) )
+			{
+				// The kernel hands the lock over: publish our writes to the new owner, which reads the word with acquire semantics.
+				AKPLATFORM::AkAtomicFetchAdd32( &m_iWord, 0, AkMemoryOrder_Release );
+				AKPLATFORM::AkFutex( &m_iWord, FUTEX_UNLOCK_PI | FUTEX_PRIVATE_FLAG, 0 );
+			}
+		}
+		else
+		{
+			if ( AKPLATFORM::AkAtomicExchange32( &m_iWord, 0, AkMemoryOrder_Release ) & FUTEX_WAITERS )
+				AKPLATFORM::AkFutex( &m_iWord, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, 1 );
+		}
+		return AK_Success;
+	}
+
+	/// Try to lock without waiting.
+	/// \return true if the lock was acquired. NOTE: CAkLock::TryLock() returns the pthread error code instead.
+	inline bool TryLock()
+	{
+		AkInt32 iThreadID = AKPLATFORM::AkFutexGetThreadID();
+		if ( IsOwner( iThreadID ) )
+		{
+			++m_uRecursion;
+			return true;
+		}
+
+		AkInt32 iExpected = 0;
+		if ( !AKPLATFORM::AkAtomicCompareExchange32( &m_iWord, iExpected, iThreadID, AkMemoryOrder_Acquire ) )
+			return false;
+
+#ifdef AK_FUTEX_STATS
+		m_stats.uNumAcquires++;
+#endif
+		m_uRecursion = 1;
+		return true;
+	}
+
+	/// Kernel thread ID of the current owner, or 0 if the lock is free.
+	AkInt32 GetOwnerThreadID() const
+	{
+		return AKPLATFORM::AkAtomicLoad32( (volatile AkAtomic32*)&m_iWord, AkMemoryOrder_Relaxed ) & FUTEX_TID_MASK;
+	}
+
+#ifdef AK_FUTEX_STATS
+	/// Contention statistics since construction or the last call to ResetStats(). Read without locking: values may be slightly stale.
+	void GetStats( AkLockStats & out_stats ) const { out_stats = m_stats; }
+	void ResetStats() { AKPLATFORM::AkMemSet( &m_stats, 0, sizeof( m_stats ) ); }
+#endif
+
+private:
+	AkForceInline bool IsOwner( AkInt32 in_iThreadID ) const
+	{
+		return ( AKPLATFORM::AkAtomicLoad32( (volatile AkAtomic32*)&m_iWord, AkMemoryOrder_Relaxed ) & FUTEX_TID_MASK ) == in_iThreadID;
+	}
+
+	// Spin for an adaptive number of iterations (based on how long previous contended acquisitions spun), then sleep in the kernel.
+	bool LockContended( AkInt32 in_iThreadID, AkInt32 in_iOwner )
+	{
+#ifdef AK_FUTEX_STATS
+		AkUInt64 uStartUs = AKPLATFORM::AkFutexNowUs();
+#else
+		(void)in_iOwner;
+#endif
+		AkInt32 iSpinEstimate = AKPLATFORM::AkAtomicLoad32( &m_iSpinEstimate, AkMemoryOrder_Relaxed );
+		AkInt32 iMaxSpins = iSpinEstimate * 2 + 10;
+		if ( iMaxSpins > AK_FUTEX_MAX_SPIN_COUNT )
+			iMaxSpins = AK_FUTEX_MAX_SPIN_COUNT;
+
+		bool bAcquired = false;
+		AkInt32 iSpins = 0;
+		while ( iSpins < iMaxSpins )
+		{
+			++iSpins;
+			AKPLATFORM::AkSpinPause();
+			AkInt32 iExpected = 0;
+			if ( AKPLATFORM::AkAtomicLoad32( &m_iWord, AkMemoryOrder_Relaxed ) == 0
+				&& AKPLATFORM::AkAtomicCompareExchange32( &m_iWord, iExpected, in_iThreadID, AkMemoryOrder_Acquire ) )
+			{
+				bAcquired = true;
+				break;
+			}
+		}
+		AKPLATFORM::AkAtomicStore32( &m_iSpinEstimate, iSpinEstimate + ( iSpins - iSpinEstimate ) / 8, AkMemoryOrder_Relaxed );
+
+		bool bSlept = false;
+		if ( !bAcquired )
+		{
+			bSlept = true;
+			bAcquired = bPriorityInheritance ? LockPI() : LockSleep( in_iThreadID );
+		}
+
+#ifdef AK_FUTEX_STATS
+		// Statistics are only updated while holding the lock.
+		if ( bAcquired )
+		{
+			AkUInt32 uWaitUs = (AkUInt32)( AKPLATFORM::AkFutexNowUs() - uStartUs );
+			m_stats.iLastContendedOwner = in_iOwner & FUTEX_TID_MASK;
+			m_stats.uNumAcquires++;
+			m_stats.uNumContended++;
+			m_stats.uNumSleeps += bSlept ? 1 : 0;
+			m_stats.uNumSpins += (AkUInt32)iSpins;
+			m_stats.uWaitTimeUs += uWaitUs;
+			if ( uWaitUs > m_stats.uMaxWaitTimeUs )
+				m_stats.uMaxWaitTimeUs = uWaitUs;
+		}
+#else
+		(void)bSlept;
+#endif
+		return bAcquired;
+	}
+
+	bool LockSleep( AkInt32 in_iThreadID )
+	{
+		// Once a thread has slept, it acquires with FUTEX_WAITERS set, since other threads may still be sleeping.
+		AkInt32 iWord = AKPLATFORM::AkAtomicLoad32( &m_iWord, AkMemoryOrder_Relaxed );
+		for (;;)
+		{
+			if ( iWord == 0 )
+			{
+				if ( AKPLATFORM::AkAtomicCompareExchange32( &m_iWord, iWord, in_iThreadID | FUTEX_WAITERS, AkMemoryOrder_Acquire ) )
+					return true;
+				continue;
+			}
+
+			if ( !( iWord & FUTEX_WAITERS ) 
+				&& !AKPLATFORM::AkAtomicCompareExchange32( &m_iWord, iWord, iWord | FUTEX_WAITERS, AkMemoryOrder_Relaxed ) )
+				continue;
+
+			AKPLATFORM::AkFutex( &m_iWord, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, iWord | FUTEX_WAITERS );
+			iWord = AKPLATFORM::AkAtomicLoad32( &m_iWord, AkMemoryOrder_Relaxed );
+		}
+	}
+
+	bool LockPI()
+	{
+		// The kernel sets the owner, FUTEX_WAITERS, and boosts the owner while we wait.
+		for (;;)
+		{
+			if ( AKPLATFORM::AkFutex( &m_iWord, FUTEX_LOCK_PI | FUTEX_PRIVATE_FLAG, 0 ) == 0 )
+			{
+				AKPLATFORM::AkAtomicLoad32( &m_iWord, AkMemoryOrder_Acquire );
+				return true;
+			}
+			if ( errno != EINTR && errno != EAGAIN )
+				return false;
+		}
+	}
+
+	volatile AkAtomic32	m_iWord;			// Owner thread ID | FUTEX_WAITERS.
+	AkUInt32			m_uRecursion;		// Only accessed by the owner.
+	volatile AkAtomic32	m_iSpinEstimate;	// Running average of spins of contended acquisitions. Updates may be lost, by design.
+#ifdef AK_FUTEX_STATS
+	AkLockStats			m_stats;
+#endif
+};
+
+typedef CAkFutexLockBase<false>	CAkFutexLock;
+typedef CAkFutexLockBase<true>	CAkFutexLockPI;
+
+//-----------------------------------------------------------------------------
+// CAkFutexEvent class
+//	Counting semaphore in a futex word: each Signal() releases one Wait(). Waiters spin briefly before sleeping.
+//-----------------------------------------------------------------------------
+class CAkFutexEvent
+{
+public:
+	CAkFutexEvent() : m_iCount( 0 ), m_iNumSleepers( 0 ) {}
+
+	/// Wait until the event is signaled, and consume one signal.
+	void Wait()
+	{
+		for ( AkInt32 iSpins = 0; iSpins < AK_FUTEX_MAX_SPIN_COUNT; ++iSpins )
+		{
+			if ( TryWait() )
+				return;
+			AKPLATFORM::AkSpinPause();
+		}
+
+		AKPLATFORM::AkAtomicFetchAdd32( &m_iNumSleepers, 1, AkMemoryOrder_SeqCst );
+		while ( !TryWait() )
+			AKPLATFORM::AkFutex( &m_iCount, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, 0 );
+		AKPLATFORM::AkAtomicFetchAdd32( &m_iNumSleepers, -1, AkMemoryOrder_Relaxed );
+	}
+
+	/// Consume one signal if the event is signaled, without waiting.
+	bool TryWait()
+	{
+		AkInt32 iCount = AKPLATFORM::AkAtomicLoad32( &m_iCount, AkMemoryOrder_Relaxed );
+		while ( iCount > 0 )
+		{
+			if ( AKPLATFORM::AkAtomicCompareExchange32( &m_iCount, iCount, iCount - 1, AkMemoryOrder_Acquire ) )
+				return true;
+		}
+		return false;
+	}
+
+	/// Signal the event, releasing one current or future Wait().
+	void Signal()
+	{
+		AKPLATFORM::AkAtomicFetchAdd32( &m_iCount, 1, AkMemoryOrder_SeqCst );
+		if ( AKPLATFORM::AkAtomicLoad32( &m_iNumSleepers, AkMemoryOrder_SeqCst ) > 0 )
+			AKPLATFORM::AkFutex( &m_iCount, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, 1 );
+	}
+
+private:
+	volatile AkAtomic32	m_iCount;
+	volatile AkAtomic32	m_iNumSleepers;
+};
@@ -34,37 +34,47 @@ the specific language governing permissions and limitations under the License.
 #include <time.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define AK_NUMA_NODE_ANY	(-1)	///< No NUMA node preference.
+#define AK_HUGE_PAGE_SIZE	(2 * 1024 * 1024)	///< Size of the huge pages used by AkHugePageAlloc().
+#define AK_SMALL_PAGE_SIZE	(4096)
 
 namespace AKPLATFORM
 {
 	// Atomic Operations
     // ------------------------------------------------------------------
+	// Full barrier semantics. See AkAtomic.h for operations with explicit memory ordering.
 
 	/// Platform Independent Helper
 	inline AkInt32 AkInterlockedIncrement(AkAtomic32 * pValue)
 	{
-		return __sync_add_and_fetch(pValue,1);
+		return __atomic_add_fetch(pValue, 1, __ATOMIC_SEQ_CST);
 	}
 
 	/// Platform Independent Helper
 	inline AkInt32 AkInterlockedDecrement(AkAtomic32 * pValue)
 	{
-		return __sync_sub_and_fetch(pValue,1);
+		return __atomic_sub_fetch(pValue, 1, __ATOMIC_SEQ_CST);
 	}
 
 	AkForceInline bool AkInterlockedCompareExchange(volatile AkAtomic32* io_pDest, AkInt32 in_newValue, AkInt32 in_expectedOldVal)
 	{
-		return __sync_bool_compare_and_swap(io_pDest, in_expectedOldVal, in_newValue);
+		return __atomic_compare_exchange_n(io_pDest, &in_expectedOldVal, in_newValue, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
 	}
 
 	AkForceInline bool AkInterlockedCompareExchange(volatile AkAtomic64* io_pDest, AkInt64 in_newValue, AkInt64 in_expectedOldVal)
 	{
-		return __sync_bool_compare_and_swap(io_pDest, in_expectedOldVal, in_newValue);
+		return __atomic_compare_exchange_n(io_pDest, &in_expectedOldVal, in_newValue, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
 	}
 
 	inline void AkMemoryBarrier()
 	{
-		__sync_synchronize();
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
 	}
 
     // Time functions
@@ -85,6 +95,147 @@ namespace AKPLATFORM
 		*out_piFreq = CLOCKS_PER_SEC;
 	}
 
+	/// CPU time consumed by a thread since it started, in microseconds (user and system).
+	/// \return 0 if the thread is invalid.
+	inline AkUInt64 AkGetThreadCPUTime( AkThread in_thread )
+	{
+		clockid_t clockID;
+		struct timespec cpuTime;
+		if ( pthread_getcpuclockid( in_thread, &clockID ) != 0 || clock_gettime( clockID, &cpuTime ) != 0 )
+			return 0;
+		return (AkUInt64)cpuTime.tv_sec * 1000000 + (AkUInt64)cpuTime.tv_nsec / 1000;
+	}
+
+	// Thread placement and memory residency
+    // ------------------------------------------------------------------
+
+	/// Lock all current and future pages of the process in RAM (mlockall), so that the audio thread takes no major page faults.
+	/// Requires CAP_IPC_LOCK or a sufficient RLIMIT_MEMLOCK. See also AkThreadOptions::bPrefaultStack.
+	/// \return AK_Success if successful, AK_Fail otherwise.
+	inline AKRESULT AkLockProcessMemory()
+	{
+		return ( mlockall( MCL_CURRENT | MCL_FUTURE ) == 0 ) ? AK_Success : AK_Fail;
+	}
+
+	/// Size of the huge pages currently backing a mapping, read from /proc/self/smaps.
+	/// \return AK_HUGE_PAGE_SIZE if at least half of the mapping is backed by huge pages, AK_SMALL_PAGE_SIZE otherwise.
+	inline AkUInt32 AkGetMappingPageSize( void * in_pAddress, size_t in_uSize )
+	{
+		FILE * pSmaps = fopen( "/proc/self/smaps", "r" );
+		if ( !pSmaps )
+			return AK_SMALL_PAGE_SIZE;
+
+		size_t uHugeBytes = 0;
+		bool bInMapping = false;
+		char szLine[ 256 ];
+		while ( fgets( szLine, sizeof( szLine ), pSmaps ) )
+		{
+			unsigned long uStart, uEnd;
+			unsigned long uKB;
+			if ( sscanf( szLine, "%lx-%lx ", &uStart, &uEnd ) == 2 )
+				bInMapping = ( uStart <= (unsigned long)in_pAddress && (unsigned long)in_pAddress < uEnd );
+			else if ( bInMapping && ( sscanf( szLine, "AnonHugePages: %lu kB", &uKB ) == 1 || sscanf( szLine, "Private_Hugetlb: %lu kB", &uKB ) == 1 ) )
+				uHugeBytes += (size_t)uKB * 1024;
+		}
+		fclose( pSmaps );
+		return ( uHugeBytes * 2 >= in_uSize ) ? AK_HUGE_PAGE_SIZE : AK_SMALL_PAGE_SIZE;
+	}
+
+	/// Touch every page of a memory block, so that it is mapped before it is used.
+	inline void AkPrefaultMemory( void * in_pMemAddress, size_t in_uSize )
+	{
+		volatile AkUInt8 * pMem = (volatile AkUInt8 *)in_pMemAddress;
+		for ( size_t uOffset = 0; uOffset < in_uSize; uOffset += AK_SMALL_PAGE_SIZE )
+			pMem[ uOffset ] = 0;
+	}
+
+	/// Map a memory block with 2 MiB pages, to reduce TLB misses and page faults in big memory pools.
+	/// Tries reserved huge pages first (MAP_HUGETLB, see /proc/sys/vm/nr_hugepages), then an aligned mapping advised 
+	/// for transparent huge pages (MADV_HUGEPAGE), which the kernel may back with small pages under memory pressure.
+	/// Use it to allocate the buffer of an AkNoAlloc pool (AK::MemoryMgr::CreatePool()); the owner of the pool, who knows its size, frees it.
+	/// It is not suitable for AK::AllocHook(), since AK::FreeHook() does not receive the size needed by AkHugePageFree().
+	/// \return The block, aligned on AK_HUGE_PAGE_SIZE, or NULL if the mapping failed. Free it with AkHugePageFree().
+	inline void * AkHugePageAlloc( 
+		size_t in_uSize,					///< Size, in bytes. Rounded up to a multiple of AK_HUGE_PAGE_SIZE.
+		bool in_bPrefault,					///< Map all pages now, rather than on first access.
+		AkUInt32 * out_puPageSize = NULL	///< Returned page size: the measured one if in_bPrefault, the expected one otherwise.
+		)
+	{
+		size_t uSize = ( in_uSize + AK_HUGE_PAGE_SIZE - 1 ) & ~( (size_t)AK_HUGE_PAGE_SIZE - 1 );
+		void * pMem = mmap( NULL, uSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | ( in_bPrefault ? MAP_POPULATE : 0 ), -1, 0 );
+		if ( pMem != MAP_FAILED )
+		{
+			if ( out_puPageSize )
+				*out_puPageSize = AK_HUGE_PAGE_SIZE;
+			return pMem;
+		}
+
+		// Over-map to align the block on a huge page boundary, then trim.
+		AkUInt8 * pRaw = (AkUInt8 *)mmap( NULL, uSize + AK_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+		if ( pRaw == MAP_FAILED )
+			return NULL;
+		AkUInt8 * pAligned = (AkUInt8 *)( ( (AkUIntPtr)pRaw + AK_HUGE_PAGE_SIZE - 1 ) & ~( (AkUIntPtr)AK_HUGE_PAGE_SIZE - 1 ) );
+		if ( pAligned > pRaw )
+			munmap( pRaw, pAligned - pRaw );
+		size_t uTail = ( pRaw + uSize + AK_HUGE_PAGE_SIZE ) - ( pAligned + uSize );
+		if ( uTail )
+			munmap( pAligned + uSize, uTail );
+
+		bool bAdvised = ( madvise( pAligned, uSize, MADV_HUGEPAGE ) == 0 );
+		if ( in_bPrefault )
+			AkPrefaultMemory( pAligned, uSize );
+		if ( out_puPageSize )
+			*out_puPageSize = !bAdvised ? AK_SMALL_PAGE_SIZE : ( in_bPrefault ? AkGetMappingPageSize( pAligned, uSize ) : AK_HUGE_PAGE_SIZE );
+		return pAligned;
+	}
+
+	/// Unmap a block returned by AkHugePageAlloc().
+	inline void AkHugePageFree( 
+		void * in_pMemAddress,		///< Block returned by AkHugePageAlloc()
+		size_t in_uSize				///< Size passed to AkHugePageAlloc()
+		)
+	{
+		size_t uSize = ( in_uSize + AK_HUGE_PAGE_SIZE - 1 ) & ~( (size_t)AK_HUGE_PAGE_SIZE - 1 );
+		munmap( in_pMemAddress, uSize );
+	}
+
+	/// NUMA node of the CPU the calling thread currently runs on.
+	/// \return The node index, or 0 if unknown.
+	inline AkInt32 AkGetCurrentNumaNode()
+	{
+		unsigned int uCpu = 0, uNode = 0;
+		if ( syscall( SYS_getcpu, &uCpu, &uNode, NULL ) != 0 )
+			return 0;
+		return (AkInt32)uNode;
+	}
+
+	/// Set a preferred NUMA node for the pages of a memory block (mbind with MPOL_PREFERRED), before they are first touched.
+	/// Call it from AK::AllocHook() to keep the pools of an engine instance local to the node its threads are pinned to.
+	/// Does not require libnuma.
+	/// \return AK_Success if successful, AK_Fail otherwise (e.g. kernel without NUMA support).
+	inline AKRESULT AkBindMemoryToNumaNode( 
+		void * in_pMemAddress,		///< Start of the block. Rounded down to a page boundary.
+		size_t in_uSize,			///< Size of the block, in bytes
+		AkInt32 in_iNode			///< NUMA node, or AK_NUMA_NODE_ANY to revert to the default local allocation policy
+		)
+	{
+		const int AK_MPOL_DEFAULT = 0;
+		const int AK_MPOL_PREFERRED = 1;
+		const size_t uNodeMaskBits = 8 * sizeof( unsigned long );
+		if ( in_iNode >= (AkInt32)uNodeMaskBits )
+			return AK_Fail;
+
+		size_t uPageSize = (size_t)sysconf( _SC_PAGESIZE );
+		size_t uStart = (size_t)in_pMemAddress & ~( uPageSize - 1 );
+		size_t uLength = (size_t)in_pMemAddress + in_uSize - uStart;
+		unsigned long uNodeMask = ( in_iNode == AK_NUMA_NODE_ANY ) ? 0 : ( 1UL << in_iNode );
+		long lResult = syscall( SYS_mbind, uStart, uLength, 
+			( in_iNode == AK_NUMA_NODE_ANY ) ? AK_MPOL_DEFAULT : AK_MPOL_PREFERRED, 
+			( in_iNode == AK_NUMA_NODE_ANY ) ? NULL : &uNodeMask, 
+			uNodeMaskBits + 1, 0 );
+		return ( lResult == 0 ) ? AK_Success : AK_Fail;
+	}
+
 	template<class destType, class srcType>
 	inline size_t AkSimpleConvertString( destType* in_pdDest, const srcType* in_pSrc, size_t in_MaxSize, size_t destStrLen(const destType *),  size_t srcStrLen(const srcType *) )
 	{ 
@@ -36,6 +36,7 @@ the specific language governing permissions and limitations under the License.
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <stdlib.h>
+#include <errno.h>
 
 #define AK_POSIX_NO_ERR 0
 #define AK_POSIX
@@ -51,6 +52,16 @@ struct AkThreadProperties
 	AkUInt32			dwAffinityMask;	///< Affinity mask
 };
 
+#ifdef AK_LINUX
+/// Linux only: additional thread creation options, passed to the AKPLATFORM::AkCreateThread() overload that accepts them.
+/// They are kept out of AkThreadProperties, whose layout is shared with the prebuilt sound engine.
+struct AkThreadOptions
+{
+	const cpu_set_t *	pCpuSet;		///< CPU set of the thread, for hosts with more than 32 CPUs. Overrides AkThreadProperties::dwAffinityMask when not NULL. Only read by AkCreateThread().
+	bool				bPrefaultStack;	///< Touch the whole stack when the thread starts, so that it takes no page faults later. Combine with AKPLATFORM::AkLockProcessMemory() to keep it resident.
+};
+#endif
+
 //-----------------------------------------------------------------------------
 // External variables.
 //-----------------------------------------------------------------------------
@@ -173,14 +184,78 @@ namespace AKPLATFORM
 		out_threadProperties.dwAffinityMask = AK_THREAD_AFFINITY_DEFAULT;	
 	}
 
+#ifdef AK_LINUX
+	/// Linux only: default AkThreadOptions, which do not change the behavior of AkCreateThread().
+	inline void AkGetDefaultThreadOptions( AkThreadOptions & out_threadOptions )
+	{
+		out_threadOptions.pCpuSet			= NULL;
+		out_threadOptions.bPrefaultStack	= false;
+	}
+
+	/// Start parameters of a thread created with AkThreadOptions::bPrefaultStack.
+	struct AkThreadStartInfo
+	{
+		AkThreadRoutine	pStartRoutine;
+		void *			pParams;
+		size_t			uPrefaultSize;
+	};
+
+	// Touch the stack in a separate frame, which is released before the thread routine runs.
+	__attribute__((noinline)) inline void AkPrefaultStack( size_t in_uSize )
+	{
+		volatile char * pStack = (volatile char *)__builtin_alloca( in_uSize );
+		for ( size_t i = 0; i < in_uSize; i += 4096 )
+			pStack[i] = 0;
+	}
+
+	inline AK_DECLARE_THREAD_ROUTINE( AkPrefaultStackThreadStart )
+	{
+		AkThreadStartInfo info = *(AkThreadStartInfo*)AK_THREAD_ROUTINE_PARAMETER;
+		free( AK_THREAD_ROUTINE_PARAMETER );
+		AkPrefaultStack( info.uPrefaultSize );
+		return info.pStartRoutine( info.pParams );
+	}
+
+	/// Convert AkThreadProperties::dwAffinityMask, or AkThreadOptions::pCpuSet when set, to a CPU set. The default mask (AK_THREAD_AFFINITY_DEFAULT) means all CPUs.
+	/// \return False if the thread may run on all CPUs.
+	inline bool AkGetThreadCpuSet( 
+		const AkThreadProperties & in_threadProperties, 
+		const AkThreadOptions * in_pThreadOptions,		// NULL for default options.
+		cpu_set_t & out_cpuSet )
+	{
+		if ( in_pThreadOptions && in_pThreadOptions->pCpuSet )
+		{
+			out_cpuSet = *in_pThreadOptions->pCpuSet;
+			return true;
+		}
+		if ( in_threadProperties.dwAffinityMask == AK_THREAD_AFFINITY_DEFAULT || in_threadProperties.dwAffinityMask == 0 )
+			return false;
+
+		CPU_ZERO( &out_cpuSet );
+		for ( int iCpu = 0; iCpu < 32; ++iCpu )
+		{
+			if ( in_threadProperties.dwAffinityMask & ( 1u << iCpu ) )
+				CPU_SET( iCpu, &out_cpuSet );
+		}
+		return true;
+	}
+#endif
+
 #ifndef AK_ANDROID 
 	/// Platform Independent Helper
 	inline void AkCreateThread( 
 		AkThreadRoutine pStartRoutine,					// Thread routine.
 		void * pParams,									// Routine params.
 		const AkThreadProperties & in_threadProperties,	// Properties. NULL for default.
+#ifdef AK_LINUX
+		const AkThreadOptions & in_threadOptions,		// Linux only: additional options.
+#endif
 		AkThread * out_pThread,							// Returned thread handle.
+#ifdef AK_LINUX
+		const char * in_szThreadName )					// Opt thread name.
+#else
 		const char * /*in_szThreadName*/ )				// Opt thread name.
+#endif
     {
 		AKASSERT( out_pThread != NULL );
 		
@@ -219,13 +294,58 @@ namespace AKPLATFORM
 			schedParam.sched_priority = in_threadProperties.nPriority;
 			AKVERIFY( !pthread_attr_setschedparam( &attr, &schedParam ));
 		}
-#ifdef AK_APPLE
+#if defined(AK_APPLE) || defined(AK_LINUX)
+		// Linux threads inherit the creator's policy by default, ignoring the one set above.
 		int inherit;
 		pthread_attr_getinheritsched(&attr, &inherit );
 		pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED );
+#endif
+#ifdef AK_LINUX
+		cpu_set_t cpuSet;
+		if ( AkGetThreadCpuSet( in_threadProperties, &in_threadOptions, cpuSet ) )
+			AKVERIFY( !pthread_attr_setaffinity_np( &attr, sizeof( cpuSet ), &cpuSet ) );
+
+		AkThreadStartInfo * pStartInfo = NULL;
+		if ( in_threadOptions.bPrefaultStack )
+		{
+			// Keep a margin for the thread's TLS and the frames of the start routine.
+			const size_t uMargin = 16 * 1024;
+			pStartInfo = (AkThreadStartInfo*)malloc( sizeof( AkThreadStartInfo ) );
+			if ( pStartInfo && in_threadProperties.uStackSize > 2 * uMargin )
+			{
+				pStartInfo->pStartRoutine = pStartRoutine;
+				pStartInfo->pParams = pParams;
+				pStartInfo->uPrefaultSize = in_threadProperties.uStackSize - uMargin;
+				pStartRoutine = AkPrefaultStackThreadStart;
+				pParams = pStartInfo;
+			}
+			else
+			{
+				free( pStartInfo );
+				pStartInfo = NULL;
+			}
+		}
 #endif
 		// Create the tread
 		int     threadError = pthread_create( out_pThread, &attr, pStartRoutine, pParams);
+#ifdef AK_LINUX
+		if ( threadError == EPERM )
+		{
+			// Real-time policies require CAP_SYS_NICE or an RLIMIT_RTPRIO: fall back to the creator's scheduling.
+			pthread_attr_setinheritsched( &attr, PTHREAD_INHERIT_SCHED );
+			threadError = pthread_create( out_pThread, &attr, pStartRoutine, pParams );
+		}
+		if ( threadError != 0 )
+			free( pStartInfo );
+		else if ( in_szThreadName )
+		{
+			// Names are limited to 15 characters.
+			char szName[16];
+			strncpy( szName, in_szThreadName, sizeof( szName ) - 1 );
+			szName[sizeof( szName ) - 1] = 0;
+			pthread_setname_np( *out_pThread, szName );
+		}
+#endif
 		AKASSERT( threadError == 0 );
 		AKVERIFY(!pthread_attr_destroy(&attr));
 		
@@ -242,6 +362,21 @@ namespace AKPLATFORM
             return;
         }		
     }
+
+#ifdef AK_LINUX
+	/// Platform Independent Helper
+	inline void AkCreateThread( 
+		AkThreadRoutine pStartRoutine,					// Thread routine.
+		void * pParams,									// Routine params.
+		const AkThreadProperties & in_threadProperties,	// Properties. NULL for default.
+		AkThread * out_pThread,							// Returned thread handle.
+		const char * in_szThreadName )					// Opt thread name.
+	{
+		AkThreadOptions threadOptions;
+		AkGetDefaultThreadOptions( threadOptions );
+		AkCreateThread( pStartRoutine, pParams, in_threadProperties, threadOptions, out_pThread, in_szThreadName );
+	}
+#endif
 #endif
 
 	/// Platform Independent Helper